@@ -7,12 +7,37 @@
 #include <assert.h>
 #include <array>
 #include <memory>
+#include <map>
+#include <mutex>
+#include <tuple>
+#include <new>
 #include <vector>
 #include <string>
 #include <cstdarg>
 #include <algorithm>
 #include <type_traits>
 
+// SIMD support (SSE/AVX on x86/x64; NEON on ARM64; otherwise scalar)
+#if defined(__AVX__)
+#include <immintrin.h>
+#define KLANG_AVX
+#endif
+#if defined(__AVX2__)
+#define KLANG_AVX2
+#endif
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define KLANG_SSE
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define KLANG_SSE2
+#endif
+#if !defined(KLANG_SSE) && defined(__ARM_NEON) && (defined(__aarch64__) || defined(_M_ARM64))
+#include <arm_neon.h>
+#define KLANG_NEON
+#endif
+
 namespace klang {
 	//template<typename Base, typename Derived>
 	//struct is_base_of_any : std::false_type {};
@@ -36,8 +61,116 @@ namespace klang {
 
 	static const constant pi = 3.1415926535897932384626433832795;
 
+	// reinterprets the bits of a value as another type of the same size (e.g. unsigned int -> float)
+	template<typename TO, typename FROM>
+	inline TO bit_cast(const FROM& from) {
+		static_assert(sizeof(TO) == sizeof(FROM), "bit_cast requires types of the same size");
+		TO to;
+		memcpy(&to, &from, sizeof(TO));
+		return to;
+	}
+
+	// fast pseudo-random number generator (per instance; reproducible for a given seed)
+	// - 8 interleaved xorshift32 lanes, so block fills can produce 8 values per step (SIMD)
+	struct Random {
+		alignas(32) unsigned int state[8];
+		int lane = 0;
+
+		Random() : Random(local().next64()) { } // (distinct, but deterministic, per thread)
+		Random(unsigned long long seed) { Random::seed(seed); }
+
+		void seed(unsigned long long seed) {
+			for (int l = 0; l < 8; l++) { // splitmix64
+				unsigned long long z = (seed += 0x9E3779B97F4A7C15ULL);
+				z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+				z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+				state[l] = (unsigned int)(z ^ (z >> 31)) | 1; // (state must be non-zero)
+			}
+			lane = 0;
+		}
+
+		unsigned int next() {
+			unsigned int x = state[lane];
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			state[lane] = x;
+			lane = (lane + 1) & 7;
+			return x;
+		}
+
+		unsigned long long next64() { return ((unsigned long long)next() << 32) | next(); }
+
+		// uniform in [-1, 1)
+		float bipolar() { return bipolar(next()); }
+
+		// uniform in [min, max)
+		template<typename TYPE>
+		TYPE operator()(const TYPE min, const TYPE max) { return TYPE(next() * (1.0 / 4294967296.0) * (max - min) + min); }
+
+		// fills a block with uniform values in [-1, 1) (same sequence as calling bipolar())
+		void fill(float* outputs, int samples) {
+			int s = 0;
+			for (; lane && s < samples; s++)
+				outputs[s] = bipolar();
+#if defined(KLANG_AVX2)
+			__m256i x = _mm256_load_si256((const __m256i*)state);
+			const __m256i exponent = _mm256_set1_epi32(0x40000000);
+			const __m256 three = _mm256_set1_ps(3.f);
+			for (; s + 8 <= samples; s += 8) {
+				x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 13));
+				x = _mm256_xor_si256(x, _mm256_srli_epi32(x, 17));
+				x = _mm256_xor_si256(x, _mm256_slli_epi32(x, 5));
+				_mm256_storeu_ps(outputs + s, _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(x, 9), exponent)), three));
+			}
+			_mm256_store_si256((__m256i*)state, x);
+#elif defined(KLANG_SSE2)
+			__m128i x[2] = { _mm_load_si128((const __m128i*)state), _mm_load_si128((const __m128i*)(state + 4)) };
+			const __m128i exponent = _mm_set1_epi32(0x40000000);
+			const __m128 three = _mm_set1_ps(3.f);
+			for (; s + 8 <= samples; s += 8) {
+				for (int h = 0; h < 2; h++) {
+					x[h] = _mm_xor_si128(x[h], _mm_slli_epi32(x[h], 13));
+					x[h] = _mm_xor_si128(x[h], _mm_srli_epi32(x[h], 17));
+					x[h] = _mm_xor_si128(x[h], _mm_slli_epi32(x[h], 5));
+					_mm_storeu_ps(outputs + s + h * 4, _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_srli_epi32(x[h], 9), exponent)), three));
+				}
+			}
+			_mm_store_si128((__m128i*)state, x[0]);
+			_mm_store_si128((__m128i*)(state + 4), x[1]);
+#elif defined(KLANG_NEON)
+			uint32x4_t x[2] = { vld1q_u32(state), vld1q_u32(state + 4) };
+			const uint32x4_t exponent = vdupq_n_u32(0x40000000);
+			const float32x4_t three = vdupq_n_f32(3.f);
+			for (; s + 8 <= samples; s += 8) {
+				for (int h = 0; h < 2; h++) {
+					x[h] = veorq_u32(x[h], vshlq_n_u32(x[h], 13));
+					x[h] = veorq_u32(x[h], vshrq_n_u32(x[h], 17));
+					x[h] = veorq_u32(x[h], vshlq_n_u32(x[h], 5));
+					vst1q_f32(outputs + s + h * 4, vsubq_f32(vreinterpretq_f32_u32(vorrq_u32(vshrq_n_u32(x[h], 9), exponent)), three));
+				}
+			}
+			vst1q_u32(state, x[0]);
+			vst1q_u32(state + 4, x[1]);
+#endif
+			for (; s < samples; s++)
+				outputs[s] = bipolar();
+		}
+
+		// generator used by random() (one per thread)
+		static Random& local() {
+			thread_local static Random random(0x853C49E6748FEA9BULL);
+			return random;
+		}
+
+	protected:
+		static float bipolar(unsigned int x) {
+			return bit_cast<float>((x >> 9) | 0x40000000) - 3.f; // [2, 4) -> [-1, 1)
+		}
+	};
+
 	template<typename TYPE>
-	static TYPE random(const TYPE min, const TYPE max) { return rand() * ((max - min) / (TYPE)RAND_MAX) + min; }
+	static TYPE random(const TYPE min, const TYPE max) { return Random::local()(min, max); }
 
 	//static float sin(float phase) { return sinf(phase); }
 
@@ -232,6 +365,124 @@ namespace klang {
 		signals operator/(int x) const { signals s = *this; for (int v = 0; v < CHANNELS; v++) s[v] /= x; return s; }
 	};
 
+	// element-wise operations on aligned arrays of N floats (using the widest available registers)
+	namespace simd {
+#ifdef KLANG_AVX
+		#define KLANG_SIMD_AVX(op)	if constexpr (N % 8 == 0) { for (int i = 0; i < N; i += 8) _mm256_store_ps(y + i, op(_mm256_load_ps(a + i), _mm256_load_ps(b + i))); return; }
+#else
+		#define KLANG_SIMD_AVX(op)
+#endif
+#if defined(KLANG_SSE)
+		#define KLANG_SIMD_128(sse, neon) if constexpr (N % 4 == 0) { for (int i = 0; i < N; i += 4) _mm_store_ps(y + i, sse(_mm_load_ps(a + i), _mm_load_ps(b + i))); return; }
+#elif defined(KLANG_NEON)
+		#define KLANG_SIMD_128(sse, neon) if constexpr (N % 4 == 0) { for (int i = 0; i < N; i += 4) vst1q_f32(y + i, neon(vld1q_f32(a + i), vld1q_f32(b + i))); return; }
+#else
+		#define KLANG_SIMD_128(sse, neon)
+#endif
+		#define KLANG_SIMD_OPERATION(name, expression, avx, sse, neon) \
+		template<int N> inline void name(float* y, const float* a, const float* b) { \
+			KLANG_SIMD_AVX(avx) \
+			KLANG_SIMD_128(sse, neon) \
+			for (int i = 0; i < N; i++) y[i] = expression; \
+		}
+
+		KLANG_SIMD_OPERATION(add, a[i] + b[i], _mm256_add_ps, _mm_add_ps, vaddq_f32)
+		KLANG_SIMD_OPERATION(sub, a[i] - b[i], _mm256_sub_ps, _mm_sub_ps, vsubq_f32)
+		KLANG_SIMD_OPERATION(mul, a[i] * b[i], _mm256_mul_ps, _mm_mul_ps, vmulq_f32)
+		KLANG_SIMD_OPERATION(div, a[i] / b[i], _mm256_div_ps, _mm_div_ps, vdivq_f32)
+		KLANG_SIMD_OPERATION(min, a[i] < b[i] ? a[i] : b[i], _mm256_min_ps, _mm_min_ps, vminq_f32)
+		KLANG_SIMD_OPERATION(max, a[i] > b[i] ? a[i] : b[i], _mm256_max_ps, _mm_max_ps, vmaxq_f32)
+
+		#undef KLANG_SIMD_OPERATION
+		#undef KLANG_SIMD_128
+		#undef KLANG_SIMD_AVX
+	}
+
+	// packed signals (one per lane; e.g. for processing 4 or 8 voices in parallel using SIMD)
+	template<int LANES = 4>
+	struct alignas(LANES % 8 == 0 ? 32 : LANES % 4 == 0 ? 16 : alignof(float)) lanes {
+		float value[LANES];
+
+		lanes(float initial = 0.f) { for (int l = 0; l < LANES; l++) value[l] = initial; }
+		lanes(constant initial) : lanes(initial.f) { }
+		lanes(double initial) : lanes((float)initial) { }
+		lanes(int initial) : lanes((float)initial) { }
+		lanes(const signal& initial) : lanes(initial.value) { }
+
+		float& operator[](int index) { return value[index]; }
+		const float& operator[](int index) const { return value[index]; }
+
+		int channels() const { return LANES; }
+
+		const lanes& operator<<(const lanes& input) {
+			return *this = input;
+		}
+
+		lanes& operator>>(lanes& destination) const {
+			return destination = *this;
+		}
+
+		lanes& operator+=(const lanes& x) { simd::add<LANES>(value, value, x.value); return *this; }
+		lanes& operator-=(const lanes& x) { simd::sub<LANES>(value, value, x.value); return *this; }
+		lanes& operator*=(const lanes& x) { simd::mul<LANES>(value, value, x.value); return *this; }
+		lanes& operator/=(const lanes& x) { simd::div<LANES>(value, value, x.value); return *this; }
+
+		lanes& operator+=(const signal& x) { return operator+=(lanes(x.value)); }
+		lanes& operator-=(const signal& x) { return operator-=(lanes(x.value)); }
+		lanes& operator*=(const signal& x) { return operator*=(lanes(x.value)); }
+		lanes& operator/=(const signal& x) { return operator/=(lanes(x.value)); }
+
+		lanes& operator+=(float x) { return operator+=(lanes(x)); }
+		lanes& operator-=(float x) { return operator-=(lanes(x)); }
+		lanes& operator*=(float x) { return operator*=(lanes(x)); }
+		lanes& operator/=(float x) { return operator/=(lanes(x)); }
+
+		lanes& operator+=(double x) { return operator+=(lanes((float)x)); }
+		lanes& operator-=(double x) { return operator-=(lanes((float)x)); }
+		lanes& operator*=(double x) { return operator*=(lanes((float)x)); }
+		lanes& operator/=(double x) { return operator/=(lanes((float)x)); }
+
+		lanes& operator+=(int x) { return operator+=(lanes((float)x)); }
+		lanes& operator-=(int x) { return operator-=(lanes((float)x)); }
+		lanes& operator*=(int x) { return operator*=(lanes((float)x)); }
+		lanes& operator/=(int x) { return operator/=(lanes((float)x)); }
+
+		lanes operator+(const lanes& x) const { lanes y; simd::add<LANES>(y.value, value, x.value); return y; }
+		lanes operator-(const lanes& x) const { lanes y; simd::sub<LANES>(y.value, value, x.value); return y; }
+		lanes operator*(const lanes& x) const { lanes y; simd::mul<LANES>(y.value, value, x.value); return y; }
+		lanes operator/(const lanes& x) const { lanes y; simd::div<LANES>(y.value, value, x.value); return y; }
+
+		lanes operator+(const signal& x) const { return operator+(lanes(x.value)); }
+		lanes operator-(const signal& x) const { return operator-(lanes(x.value)); }
+		lanes operator*(const signal& x) const { return operator*(lanes(x.value)); }
+		lanes operator/(const signal& x) const { return operator/(lanes(x.value)); }
+
+		lanes operator+(float x) const { return operator+(lanes(x)); }
+		lanes operator-(float x) const { return operator-(lanes(x)); }
+		lanes operator*(float x) const { return operator*(lanes(x)); }
+		lanes operator/(float x) const { return operator/(lanes(x)); }
+
+		lanes operator+(double x) const { return operator+(lanes((float)x)); }
+		lanes operator-(double x) const { return operator-(lanes((float)x)); }
+		lanes operator*(double x) const { return operator*(lanes((float)x)); }
+		lanes operator/(double x) const { return operator/(lanes((float)x)); }
+
+		lanes operator+(int x) const { return operator+(lanes((float)x)); }
+		lanes operator-(int x) const { return operator-(lanes((float)x)); }
+		lanes operator*(int x) const { return operator*(lanes((float)x)); }
+		lanes operator/(int x) const { return operator/(lanes((float)x)); }
+
+		lanes operator-() const { return lanes(0.f) - *this; }
+	};
+
+	template<int LANES> inline lanes<LANES> operator+(float x, const lanes<LANES>& y) { return lanes<LANES>(x) + y; }
+	template<int LANES> inline lanes<LANES> operator-(float x, const lanes<LANES>& y) { return lanes<LANES>(x) - y; }
+	template<int LANES> inline lanes<LANES> operator*(float x, const lanes<LANES>& y) { return lanes<LANES>(x) * y; }
+	template<int LANES> inline lanes<LANES> operator/(float x, const lanes<LANES>& y) { return lanes<LANES>(x) / y; }
+
+	template<int LANES> inline lanes<LANES> min(const lanes<LANES>& a, const lanes<LANES>& b) { lanes<LANES> y; simd::min<LANES>(y.value, a.value, b.value); return y; }
+	template<int LANES> inline lanes<LANES> max(const lanes<LANES>& a, const lanes<LANES>& b) { lanes<LANES> y; simd::max<LANES>(y.value, a.value, b.value); return y; }
+
 	struct increment {
 		float amount;
 		const float size;
@@ -262,12 +513,6 @@ namespace klang {
 
 	// signal used as a control parameter (possibly at audio rate)
 	class param : public signal {
-		struct ptr : public std::shared_ptr<param> {
-			ptr(param* p) : std::shared_ptr<param>(p) { }
-			virtual ~ptr() { }
-			operator const param () { return *get(); }
-		};
-
 	protected:
 		virtual Type type() const { return Type::Generic; }
 
@@ -287,11 +532,13 @@ namespace klang {
 			return *this;
 		}
 
-		void convert(const param& from, param& to);
-		virtual param* convert(Type to);
+		static float convert(float value, Conversion direction);
+		static void convert(const param& from, param& to);
+		param convert(Type to) const;
 
-		ptr operator>(Type type) {
-			return ptr(convert(type));
+		// convert to another unit (e.g. pitch > Type::Frequency; by value, no allocation)
+		param operator>(Type type) const {
+			return convert(type);
 		}
 	};
 
@@ -361,43 +608,188 @@ namespace klang {
 		return (*(const double*)&i - 1.0) * size;
 	}
 
-	template<typename TYPE, typename _TYPE>
-	struct phase {
-		static constexpr TYPE twoPi = TYPE(2.0 * 3.1415926535897932384626433832795);
+	// fast 2^x (max. relative error ~1e-7; x clamped to [-126, 128))
+	inline float fast_exp2(float x) {
+		x = x < -126.f ? -126.f : x > 127.99998f ? 127.99998f : x;
+		int i = (int)x;
+		i -= x < (float)i;	// floor
+		const float f = x - (float)i;
+		const float p = ((((1.893754058e-03f * f + 8.949590423e-03f) * f + 5.586033708e-02f) * f + 2.401418182e-01f) * f + 6.931544897e-01f) * f + 9.999998984e-01f;
+		return p * bit_cast<float>((unsigned int)(i + 127) << 23);
+	}
 
-		// represent phase using full range of uint32
-		// (integer math, no conditionals, free oversampling)
-		_TYPE i = 0;
+	// fast log2(x) (polynomial error ~2e-7, before rounding; x > 0)
+	inline float fast_log2(float x) {
+		const unsigned int i = bit_cast<unsigned int>(x);
+		const float t = bit_cast<float>((i & 0x007FFFFF) | 0x3F800000) - 1.f;	// mantissa [0, 1)
+		const float q = ((((((-1.207702027e-02f * t + 6.274843357e-02f) * t - 1.541520064e-01f) * t + 2.551763492e-01f) * t - 3.530963533e-01f) * t + 4.800124608e-01f) * t - 7.213067574e-01f) * t + 1.442694725e+00f;
+		return (float)((int)(i >> 23) - 127) + t * q;
+	}
 
-		// convert float [0, 2pi) to uint32
-		phase(TYPE phase = 0) {
-			if constexpr (std::is_same<TYPE, double>()) {
-				constexpr TYPE FUINTMAX = TYPE(ULLONG_MAX + 1.0) / twoPi; // (float)INT_MAX + 1.f;
-				phase *= FUINTMAX;
-				i = (_TYPE)phase;
-			} else if constexpr (std::is_same<TYPE, float>()) {
-				constexpr TYPE FUINTMAX = TYPE(UINT_MAX + 1.0) / twoPi; // (float)INT_MAX + 1.f;
-				phase *= FUINTMAX;
-				i = (_TYPE)phase;
-			}
+#if defined(KLANG_AVX2)
+	inline __m256 fast_exp2(__m256 x) {
+		x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-126.f)), _mm256_set1_ps(127.99998f));
+		const __m256 fi = _mm256_floor_ps(x);
+		const __m256 f = _mm256_sub_ps(x, fi);
+		__m256 p = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(1.893754058e-03f), f), _mm256_set1_ps(8.949590423e-03f));
+		p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(5.586033708e-02f));
+		p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(2.401418182e-01f));
+		p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(6.931544897e-01f));
+		p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(9.999998984e-01f));
+		const __m256i e = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvtps_epi32(fi), _mm256_set1_epi32(127)), 23);
+		return _mm256_mul_ps(p, _mm256_castsi256_ps(e));
+	}
+
+	inline __m256 fast_log2(__m256 x) {
+		const __m256i i = _mm256_castps_si256(x);
+		const __m256 t = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(i, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F800000))), _mm256_set1_ps(1.f));
+		__m256 q = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-1.207702027e-02f), t), _mm256_set1_ps(6.274843357e-02f));
+		q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(-1.541520064e-01f));
+		q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(2.551763492e-01f));
+		q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(-3.530963533e-01f));
+		q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(4.800124608e-01f));
+		q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(-7.213067574e-01f));
+		q = _mm256_add_ps(_mm256_mul_ps(q, t), _mm256_set1_ps(1.442694725e+00f));
+		const __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(i, 23), _mm256_set1_epi32(127)));
+		return _mm256_add_ps(e, _mm256_mul_ps(t, q));
+	}
+#endif
+#if defined(KLANG_SSE2)
+	inline __m128 fast_exp2(__m128 x) {
+		x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-126.f)), _mm_set1_ps(127.99998f));
+		__m128i i = _mm_cvttps_epi32(x);
+		i = _mm_add_epi32(i, _mm_castps_si128(_mm_cmpgt_ps(_mm_cvtepi32_ps(i), x))); // floor
+		const __m128 f = _mm_sub_ps(x, _mm_cvtepi32_ps(i));
+		__m128 p = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.893754058e-03f), f), _mm_set1_ps(8.949590423e-03f));
+		p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(5.586033708e-02f));
+		p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(2.401418182e-01f));
+		p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(6.931544897e-01f));
+		p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(9.999998984e-01f));
+		const __m128i e = _mm_slli_epi32(_mm_add_epi32(i, _mm_set1_epi32(127)), 23);
+		return _mm_mul_ps(p, _mm_castsi128_ps(e));
+	}
+
+	inline __m128 fast_log2(__m128 x) {
+		const __m128i i = _mm_castps_si128(x);
+		const __m128 t = _mm_sub_ps(_mm_castsi128_ps(_mm_or_si128(_mm_and_si128(i, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F800000))), _mm_set1_ps(1.f));
+		__m128 q = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.207702027e-02f), t), _mm_set1_ps(6.274843357e-02f));
+		q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(-1.541520064e-01f));
+		q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(2.551763492e-01f));
+		q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(-3.530963533e-01f));
+		q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(4.800124608e-01f));
+		q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(-7.213067574e-01f));
+		q = _mm_add_ps(_mm_mul_ps(q, t), _mm_set1_ps(1.442694725e+00f));
+		const __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(i, 23), _mm_set1_epi32(127)));
+		return _mm_add_ps(e, _mm_mul_ps(t, q));
+	}
+#elif defined(KLANG_NEON)
+	inline float32x4_t fast_exp2(float32x4_t x) {
+		x = vminq_f32(vmaxq_f32(x, vdupq_n_f32(-126.f)), vdupq_n_f32(127.99998f));
+		const int32x4_t i = vcvtmq_s32_f32(x); // floor
+		const float32x4_t f = vsubq_f32(x, vcvtq_f32_s32(i));
+		float32x4_t p = vmlaq_n_f32(vdupq_n_f32(8.949590423e-03f), f, 1.893754058e-03f);
+		p = vmlaq_f32(vdupq_n_f32(5.586033708e-02f), p, f);
+		p = vmlaq_f32(vdupq_n_f32(2.401418182e-01f), p, f);
+		p = vmlaq_f32(vdupq_n_f32(6.931544897e-01f), p, f);
+		p = vmlaq_f32(vdupq_n_f32(9.999998984e-01f), p, f);
+		const int32x4_t e = vshlq_n_s32(vaddq_s32(i, vdupq_n_s32(127)), 23);
+		return vmulq_f32(p, vreinterpretq_f32_s32(e));
+	}
+
+	inline float32x4_t fast_log2(float32x4_t x) {
+		const uint32x4_t i = vreinterpretq_u32_f32(x);
+		const float32x4_t t = vsubq_f32(vreinterpretq_f32_u32(vorrq_u32(vandq_u32(i, vdupq_n_u32(0x007FFFFF)), vdupq_n_u32(0x3F800000))), vdupq_n_f32(1.f));
+		float32x4_t q = vmlaq_n_f32(vdupq_n_f32(6.274843357e-02f), t, -1.207702027e-02f);
+		q = vmlaq_f32(vdupq_n_f32(-1.541520064e-01f), q, t);
+		q = vmlaq_f32(vdupq_n_f32(2.551763492e-01f), q, t);
+		q = vmlaq_f32(vdupq_n_f32(-3.530963533e-01f), q, t);
+		q = vmlaq_f32(vdupq_n_f32(4.800124608e-01f), q, t);
+		q = vmlaq_f32(vdupq_n_f32(-7.213067574e-01f), q, t);
+		q = vmlaq_f32(vdupq_n_f32(1.442694725e+00f), q, t);
+		const float32x4_t e = vcvtq_f32_s32(vsubq_s32(vreinterpretq_s32_u32(vshrq_n_u32(i, 23)), vdupq_n_s32(127)));
+		return vmlaq_f32(e, t, q);
+	}
+#endif
+
+	// block 2^(in * scale + offset)
+	inline void fast_exp2(const float* in, float* out, int size, float scale = 1.f, float offset = 0.f) {
+		int s = 0;
+#if defined(KLANG_AVX2)
+		for (; s + 8 <= size; s += 8)
+			_mm256_storeu_ps(out + s, fast_exp2(_mm256_add_ps(_mm256_mul_ps(_mm256_loadu_ps(in + s), _mm256_set1_ps(scale)), _mm256_set1_ps(offset))));
+#endif
+#if defined(KLANG_SSE2)
+		for (; s + 4 <= size; s += 4)
+			_mm_storeu_ps(out + s, fast_exp2(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(in + s), _mm_set1_ps(scale)), _mm_set1_ps(offset))));
+#elif defined(KLANG_NEON)
+		for (; s + 4 <= size; s += 4)
+			vst1q_f32(out + s, fast_exp2(vmlaq_n_f32(vdupq_n_f32(offset), vld1q_f32(in + s), scale)));
+#endif
+		for (; s < size; s++)
+			out[s] = fast_exp2(in[s] * scale + offset);
+	}
+
+	// block log2(in) * scale + offset
+	inline void fast_log2(const float* in, float* out, int size, float scale = 1.f, float offset = 0.f) {
+		int s = 0;
+#if defined(KLANG_AVX2)
+		for (; s + 8 <= size; s += 8)
+			_mm256_storeu_ps(out + s, _mm256_add_ps(_mm256_mul_ps(fast_log2(_mm256_loadu_ps(in + s)), _mm256_set1_ps(scale)), _mm256_set1_ps(offset)));
+#endif
+#if defined(KLANG_SSE2)
+		for (; s + 4 <= size; s += 4)
+			_mm_storeu_ps(out + s, _mm_add_ps(_mm_mul_ps(fast_log2(_mm_loadu_ps(in + s)), _mm_set1_ps(scale)), _mm_set1_ps(offset)));
+#elif defined(KLANG_NEON)
+		for (; s + 4 <= size; s += 4)
+			vst1q_f32(out + s, vmlaq_n_f32(vdupq_n_f32(offset), fast_log2(vld1q_f32(in + s)), scale));
+#endif
+		for (; s < size; s++)
+			out[s] = fast_log2(in[s]) * scale + offset;
+	}
+
+	// pitch (MIDI note), frequency (Hz) and gain (dB) conversions
+	// - allocation-free and audio-rate safe; fast approximations by default, or PRECISE (C library)
+	// - block forms convert arrays in place or out of place (e.g. for modulation buffers)
+	namespace conversion {
+		constexpr float log2_440 = 8.7813597135246596f;	// log2(440)
+		constexpr float log2_10 = 3.3219280948873623f;	// log2(10)
+
+		template<bool PRECISE = false> inline float pitch2frequency(float pitch) {
+			return PRECISE ? 440.f * exp2f((pitch - 69.f) * (1.f / 12.f)) : fast_exp2(pitch * (1.f / 12.f) + (log2_440 - 69.f / 12.f));
 		}
 
-		// convert uint32 to float [0, 1)
-		operator TYPE() const {
-			//const _TYPE phase = (i >> 9) | 0x3f800000;
-			const _TYPE phase = (i >> 12ULL) | 0x3FF0000000000000ULL;
-			return (*(const TYPE*)&phase - TYPE(1.0)) * twoPi;
+		template<bool PRECISE = false> inline float frequency2pitch(float frequency) {
+			return PRECISE ? 12.f * log2f(frequency * (1.f / 440.f)) + 69.f : fast_log2(frequency) * 12.f + (69.f - 12.f * log2_440);
 		}
 
-		//static void test() {
-		//	phase p;
-		//	assert((float)(p = 0.f).radians() == 0.f);
-		//	assert((float)(p = pi / 2).radians() == pi / 2);
-		//	assert((float)(p = pi).radians() == pi);
-		//	assert((float)(p = 3 * pi / 2).radians() == 3 * pi / 2);
-		//	assert((float)(p = 2 * pi).radians() == 0.f);
-		//}
-	};
+		template<bool PRECISE = false> inline float dB2amplitude(float dB) {
+			return PRECISE ? powf(10.f, dB * 0.05f) : fast_exp2(dB * (0.05f * log2_10));
+		}
+
+		template<bool PRECISE = false> inline float amplitude2dB(float amplitude) {
+			return PRECISE ? 20.f * log10f(amplitude) : fast_log2(amplitude) * (20.f / log2_10);
+		}
+
+		template<bool PRECISE = false> inline void pitch2frequency(const float* pitch, float* frequency, int size) {
+			if (PRECISE) for (int s = 0; s < size; s++) frequency[s] = pitch2frequency<true>(pitch[s]);
+			else fast_exp2(pitch, frequency, size, 1.f / 12.f, log2_440 - 69.f / 12.f);
+		}
+
+		template<bool PRECISE = false> inline void frequency2pitch(const float* frequency, float* pitch, int size) {
+			if (PRECISE) for (int s = 0; s < size; s++) pitch[s] = frequency2pitch<true>(frequency[s]);
+			else fast_log2(frequency, pitch, size, 12.f, 69.f - 12.f * log2_440);
+		}
+
+		template<bool PRECISE = false> inline void dB2amplitude(const float* dB, float* amplitude, int size) {
+			if (PRECISE) for (int s = 0; s < size; s++) amplitude[s] = dB2amplitude<true>(dB[s]);
+			else fast_exp2(dB, amplitude, size, 0.05f * log2_10);
+		}
+
+		template<bool PRECISE = false> inline void amplitude2dB(const float* amplitude, float* dB, int size) {
+			if (PRECISE) for (int s = 0; s < size; s++) dB[s] = amplitude2dB<true>(amplitude[s]);
+			else fast_log2(amplitude, dB, size, 20.f / log2_10);
+		}
+	}
 
 	struct Phase : public param {
 		Type type() const { return Type::Phase; };
@@ -466,6 +858,87 @@ namespace klang {
 
 	static Frequency fs = 44100.f; // sample rate
 
+	// fixed-point phase (full range of _TYPE = one cycle; integer math, exact accumulation, wraps for free)
+	// - phase<float, unsigned int> matches the 32-bit phase of the Fast oscillators
+	// - phase<float, unsigned long long> accumulates without drift (e.g. for long-running modulators)
+	template<typename TYPE = float, typename _TYPE = unsigned long long>
+	struct phase {
+		static_assert(std::is_unsigned<_TYPE>() && sizeof(_TYPE) >= 4, "phase requires a 32-bit or 64-bit unsigned type");
+
+		static constexpr int BITS = sizeof(_TYPE) * 8;
+		static constexpr double RANGE = double(_TYPE(1) << (BITS - 1)) * 2.0;	// 2^BITS
+		static constexpr TYPE twoPi = TYPE(2.0 * 3.1415926535897932384626433832795);
+
+		_TYPE i = 0;
+
+		phase() = default;
+
+		// convert radians to phase
+		phase(TYPE radians) { *this = cycles(double(radians) * (1.0 / (2.0 * 3.1415926535897932384626433832795))); }
+
+		// convert cycles (any range) to phase
+		static phase cycles(double cycles) {
+			cycles -= floor(cycles);
+			const double x = cycles * RANGE + 0.5;	// round to nearest
+			phase p;
+			p.i = x < RANGE ? (_TYPE)x : 0;
+			return p;
+		}
+
+		// increment per sample for a frequency (in Hz; rounded to nearest, via double - so 53 significant bits)
+		static phase frequency(double frequency) { return cycles(frequency / double(fs)); }
+
+		// convert from a 32-bit phase (full range = one cycle)
+		static phase fixed(unsigned int phase32) {
+			phase p;
+			p.i = _TYPE(phase32) << (BITS - 32);
+			return p;
+		}
+
+		// upper 32 bits (e.g. for table lookup or the 32-bit SIMD kernels)
+		unsigned int top() const { return (unsigned int)(i >> (BITS - 32)); }
+
+		// upper 32 bits of each of the next [count] phases (stepping the full-width phase, as per sample)
+		void tops(const phase& increment, unsigned int offset, unsigned int* phases, int count) const {
+			_TYPE p = i;
+			for (int n = 0; n < count; n++, p += increment.i)
+				phases[n] = (unsigned int)(p >> (BITS - 32)) + offset;
+		}
+
+		// convert to [0, 1)
+		TYPE cycles() const {
+			constexpr int SHIFT = BITS > std::numeric_limits<TYPE>::digits ? BITS - std::numeric_limits<TYPE>::digits : 0;
+			return TYPE(i >> SHIFT) * TYPE(1.0 / double(_TYPE(1) << (BITS - SHIFT - 1)) * 0.5);
+		}
+
+		// convert to radians [0, 2pi)
+		TYPE radians() const { return cycles() * twoPi; }
+		operator TYPE() const { return radians(); }
+
+		phase& operator+=(const phase& in) { i += in.i; return *this; }
+		phase operator+(const phase& in) const { phase p; p.i = i + in.i; return p; }
+		phase operator-(const phase& in) const { phase p; p.i = i - in.i; return p; }
+		phase operator*(unsigned int n) const { phase p; p.i = i * n; return p; }
+
+		//static void test() {
+		//	phase p;
+		//	assert((float)(p = 0.f).radians() == 0.f);
+		//	assert((float)(p = pi / 2).radians() == pi / 2);
+		//	assert((float)(p = pi).radians() == pi);
+		//	assert((float)(p = 3 * pi / 2).radians() == 3 * pi / 2);
+		//	assert((float)(p = 2 * pi).radians() == 0.f);
+		//}
+	};
+
+	// phase accumulator used by the oscillators (define KLANG_PHASE64 for 64-bit, e.g. for installations)
+	// - used by Basic oscillators, Fast::Sine, Static::Sine and Wavetable; the other Fast oscillators,
+	//   Unison, Additive and Lanes keep 32-bit phases
+#ifdef KLANG_PHASE64
+	typedef phase<float, unsigned long long> accumulator;
+#else
+	typedef phase<float, unsigned int> accumulator;
+#endif
+
 	template<typename TYPE>
 	inline static TYPE operator<(Type type, const TYPE& source) {
 
@@ -486,13 +959,13 @@ namespace klang {
 		//INFO("Gain", 1.f, -FLT_MAX, FLT_MAX)
 		using param::param;
 
+		Type type() const { return Type::Amplitude; };
+
 		Amplitude(float a = 1.f) : param(a) { };
-		Amplitude(const dB& db) {
-			value = powf(10.f, db.value * 0.05f);
-		};
+		Amplitude(const dB& db) : param(conversion::dB2amplitude(db.value)) { };
 
 		operator dB() const {
-			return 20.f * log10f(value);
+			return conversion::amplitude2dB(value);
 		}
 	};
 
@@ -651,12 +1124,75 @@ namespace klang {
 		}
 	};
 	
+	// aligned memory arena for buffers (bump allocation from large blocks; a block is released once
+	// the pool and every buffer using it are gone, so no per-buffer heap allocation or fragmentation)
+	class Pool {
+		struct Block {
+			float* data;
+			int capacity, used = 0;
+
+			Block(int capacity) : data((float*)::operator new(sizeof(float) * capacity, std::align_val_t(ALIGNMENT))), capacity(capacity) { }
+			~Block() { ::operator delete(data, std::align_val_t(ALIGNMENT)); }
+		};
+
+		std::shared_ptr<Block> block;
+
+		static Pool*& active() { thread_local static Pool* pool = nullptr; return pool; }
+
+	public:
+		static constexpr int ALIGNMENT = 64;		// bytes (cache line / widest SIMD register)
+		static constexpr int BLOCK_SIZE = 65536;	// minimum block size (floats)
+
+		// ensures the next allocations (up to size floats) can be made without using the heap
+		// - an exhausted pool takes a new block from the heap, so reserve() ahead of audio-thread use
+		void reserve(int size) {
+			if (!block || (block->capacity - block->used) < size)
+				block = std::make_shared<Block>(std::max(int(BLOCK_SIZE), align(size)));
+		}
+
+		// returns aligned storage for size floats (shared ownership of the underlying block)
+		// - heap-allocates a new block if the pool is exhausted (see reserve())
+		std::shared_ptr<float> allocate(int size) {
+			size = align(size);
+			reserve(size);
+			float* samples = block->data + block->used;
+			block->used += size;
+			return std::shared_ptr<float>(block, samples);
+		}
+
+		// rounds a size (in floats) up to the pool's alignment
+		static int align(int size) {
+			constexpr int floats = ALIGNMENT / sizeof(float);
+			return (size + floats - 1) & ~(floats - 1);
+		}
+
+		// selects the pool used for new buffers on this thread (nullptr = default)
+		static void use(Pool* pool) { active() = pool; }
+
+		// returns the pool used for new buffers on this thread
+		static Pool& current() {
+			thread_local static Pool pool;
+			return active() ? *active() : pool;
+		}
+
+		// makes a pool current on this thread for the guard's lifetime (nullptr = keep the current pool)
+		class Scope {
+			Pool* const previous;
+		public:
+			Scope(Pool* pool = nullptr) : previous(active()) { if (pool) active() = pool; }
+			~Scope() { active() = previous; }
+
+			Scope(const Scope&) = delete;
+			Scope& operator=(const Scope&) = delete;
+		};
+	};
+
 	class buffer {
 	protected:
 		float* samples;
 		signal* ptr;
 		signal* end;
-		bool owned = false;
+		std::shared_ptr<float> storage; // owned storage (from Pool)
 	public:
 		const int size;
 
@@ -672,17 +1208,13 @@ namespace klang {
 		}
 
 		buffer(int size, float initial = 0)
-		: samples(new float[size]), owned(true), size(size) {
-			samples = new float[size];
-
+		: storage(Pool::current().allocate(size)), size(size) {
+			samples = storage.get();
 			rewind();
 			set(initial);
 		}
 
-		virtual ~buffer() {
-			if (owned)
-				delete[] samples;
-		}
+		virtual ~buffer() { }
 
 		void rewind(int offset = 0) {
 			ptr = (signal*)&samples[offset];
@@ -701,6 +1233,11 @@ namespace klang {
 			return int((signal*)&samples[0] - ptr);
 		}
 
+		// samples left from the current position
+		int remaining() const {
+			return int(end - ptr);
+		}
+
 		void set(float value = 0) {
 			if (value == 0)
 				clear();
@@ -792,6 +1329,7 @@ namespace klang {
 	struct Debug {
 		buffer* buffer = nullptr;
 		Console console;
+		alignas(klang::buffer) char storage[sizeof(klang::buffer)]; // (avoids heap allocation when attaching)
 
 		enum Content {
 			Empty = 0,
@@ -801,13 +1339,15 @@ namespace klang {
 		} content = Empty;
 
 		void attach(float* buffer, int size) {
-				Debug::buffer = new klang::buffer(buffer, size);
+			detach();
+			Debug::buffer = new (storage) klang::buffer(buffer, size);
 		}
 
 		void detach() {
 			klang::buffer* tmp = buffer;
 			buffer = nullptr;
-			delete tmp;
+			if (tmp)
+				tmp->~buffer();
 		}
 
 		struct Session {
@@ -1247,12 +1787,23 @@ namespace klang {
 
 		template<typename SIGNAL> 
 		struct Generator : public Output<SIGNAL> { 
+			using Output<SIGNAL>::out;
+			using Output<SIGNAL>::process;
+
 			// inline parameter(s) support
 			template<typename... params>
 			Output<SIGNAL>& operator()(params... p) {
 				set(p...); return *this;
 			}
 
+			// block processing (default: calls process() for each sample)
+			virtual void process(SIGNAL* outputs, int samples) {
+				for (int s = 0; s < samples; s++) {
+					process();
+					outputs[s] = out;
+				}
+			}
+
 		protected:
 			virtual void set(param p) { };
 			virtual void set(relative p) { };
@@ -1271,6 +1822,15 @@ namespace klang {
 			operator SIGNAL() override { process(); return out; } // return last output
 			virtual void process() override { out = in; }
 
+			// block processing (default: calls process() for each sample; supports in-place)
+			virtual void process(const SIGNAL* inputs, SIGNAL* outputs, int samples) {
+				for (int s = 0; s < samples; s++) {
+					Input<SIGNAL>::input(inputs[s]);
+					process();
+					outputs[s] = out;
+				}
+			}
+
 			// inline parameter(s) support
 			template<typename... params>
 			Modifier<SIGNAL>& operator()(params... p) {
@@ -1338,24 +1898,157 @@ namespace klang {
 		return modifier;
 	}
 
-	template<int SIZE>
+	// static-dispatch (CRTP) components (no virtual process/set, so signal chains can be inlined)
+	namespace Static {
+		template<class DERIVED, typename SIGNAL = klang::signal>
+		struct Output {
+			SIGNAL out = 0;
+
+			SIGNAL& output() { return out; }
+			const SIGNAL& output() const { return out; }
+			SIGNAL& operator>>(SIGNAL& destination) { derived().process(); return destination = out; }
+
+			operator SIGNAL() { derived().process(); return out; }
+
+			template<typename TYPE> SIGNAL operator+(TYPE& other) { derived().process(); return out + SIGNAL(other); }
+			template<typename TYPE> SIGNAL operator*(TYPE& other) { derived().process(); return out * SIGNAL(other); }
+			template<typename TYPE> SIGNAL operator-(TYPE& other) { derived().process(); return out - SIGNAL(other); }
+			template<typename TYPE> SIGNAL operator/(TYPE& other) { derived().process(); return out / SIGNAL(other); }
+
+		protected:
+			DERIVED& derived() { return static_cast<DERIVED&>(*this); }
+		};
+
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator+(float other, Output<DERIVED, SIGNAL>& output) { return SIGNAL(output) + other; }
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator*(float other, Output<DERIVED, SIGNAL>& output) { return SIGNAL(output) * other; }
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator-(float other, Output<DERIVED, SIGNAL>& output) { return SIGNAL(other) - SIGNAL(output); }
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator/(float other, Output<DERIVED, SIGNAL>& output) { return SIGNAL(other) / SIGNAL(output); }
+
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator+(Output<DERIVED, SIGNAL>& output, float other) { return SIGNAL(output) + other; }
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator*(Output<DERIVED, SIGNAL>& output, float other) { return SIGNAL(output) * other; }
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator-(Output<DERIVED, SIGNAL>& output, float other) { return SIGNAL(output) - other; }
+		template<class DERIVED, typename SIGNAL> inline SIGNAL operator/(Output<DERIVED, SIGNAL>& output, float other) { return SIGNAL(output) / other; }
+
+		template<class DERIVED, typename SIGNAL = klang::signal>
+		struct Generator : public Output<DERIVED, SIGNAL> {
+			using Output<DERIVED, SIGNAL>::out;
+			using Output<DERIVED, SIGNAL>::derived;
+
+			// inline parameter(s) support
+			template<typename... params>
+			DERIVED& operator()(params... p) {
+				derived().set(p...); return derived();
+			}
+
+			// block processing (default: calls process() for each sample)
+			void process(SIGNAL* outputs, int samples) {
+				for (int s = 0; s < samples; s++) {
+					derived().process();
+					outputs[s] = out;
+				}
+			}
+		};
+
+		template<class DERIVED, typename SIGNAL = klang::signal>
+		struct Modifier : public Output<DERIVED, SIGNAL> {
+			using Output<DERIVED, SIGNAL>::out;
+			using Output<DERIVED, SIGNAL>::derived;
+
+			SIGNAL in = 0;
+
+			SIGNAL& input() { return in; }
+			const SIGNAL& input() const { return in; }
+			void input(const SIGNAL& source) { in = source; }
+			void operator<<(const SIGNAL& source) { derived().input(source); }
+
+			// signal processing (input-output)
+			void process() { out = in; }
+
+			// inline parameter(s) support
+			template<typename... params>
+			DERIVED& operator()(params... p) {
+				derived().set(p...); return derived();
+			}
+
+			// block processing (default: calls process() for each sample; supports in-place)
+			void process(const SIGNAL* inputs, SIGNAL* outputs, int samples) {
+				for (int s = 0; s < samples; s++) {
+					derived().input(inputs[s]);
+					derived().process();
+					outputs[s] = out;
+				}
+			}
+		};
+
+		// source is a non-deduced context, so accepts signals, floats or any (static or virtual) output
+		template<class DERIVED, typename SIGNAL>
+		inline DERIVED& operator>>(std::common_type_t<SIGNAL> input, Modifier<DERIVED, SIGNAL>& modifier) {
+			modifier << input;
+			return static_cast<DERIVED&>(modifier);
+		}
+
+		template<class DERIVED, typename SIGNAL = klang::signal>
+		struct Oscillator : public Generator<DERIVED, SIGNAL> {
+			using Generator<DERIVED, SIGNAL>::derived;
+		protected:
+			Phase increment;				// phase increment (per sample, in seconds or samples)
+			Phase position = 0;				// phase position (in radians or wavetable size)
+		public:
+			Frequency frequency = 1000.f;	// fundamental frequency of oscillator (in Hz)
+			Phase offset = 0;				// phase offset (in radians - e.g. for modulation)
+
+			void reset() { position = 0; }
+
+			void set(param frequency) {
+				Oscillator::frequency = frequency;
+				increment = frequency * 2.f * pi.f / fs;
+			}
+
+			void set(param frequency, param phase) {
+				position = phase;
+				derived().set(frequency);
+			}
+
+			void set(param frequency, relative phase) {
+				derived().set(frequency);
+				derived().set(phase);
+			}
+
+			void set(relative phase) {
+				offset = phase * (2 * pi);
+			}
+		};
+	}
+
+	template<int SIZE = 0>
 	class Delay : public Modifier {
 	protected:
 		float buffer[SIZE];
 		const int size = SIZE;
 		float time = 1;
 		int position = 0;
+		int written = SIZE;	// samples written since the last clear (only these can be non-zero)
 	public:
 		Delay() { clear(); }
 
+		// zeroes the line (cost proportional to the samples written since the last clear)
 		void clear() {
-			memset(buffer, 0, sizeof(float) * SIZE);
+			const int start = position - written;
+			if (start >= 0) {
+				memset(&buffer[start], 0, sizeof(float) * written);
+			} else {
+				memset(buffer, 0, sizeof(float) * position);
+				memset(&buffer[SIZE + start], 0, sizeof(float) * -start);
+			}
+			written = 0;
 		}
 
 		void operator<<(const signal& input) override {
 			buffer[position] = Delay::in = input;
 			if(++position == SIZE)
 				position = 0;
+			if (written < SIZE)
+				written++;
 		}
 
 		signal tap(float delay) const {
@@ -1385,1394 +2078,5059 @@ namespace klang {
 			out = tap(time);
 		}
 
+		virtual void process(const signal* inputs, signal* outputs, int samples) override {
+			for (int s = 0; s < samples; s++) {
+				Delay::operator<<(inputs[s]);
+				outputs[s] = tap(time);
+			}
+			if (samples)
+				out = outputs[samples - 1];
+		}
+
 		virtual void set(param delay) override {
 			assert(delay <= SIZE);
 			Delay::time = delay;
 		}
 	};
 
-	class Noise : public Generator {
-		void process() {
-			out = (rand() / (float)RAND_MAX) * 2.f - 1.f;
-		}
-	};
-
-	class Wavetable : public Oscillator {
-		using Oscillator::set;
+	// delay line with a runtime capacity (e.g. Delay<> delay { 2048 }; or resize() at setup)
+	// - capacity is rounded up to a power of two, so the write position wraps with a mask
+	// - storage comes from the current Pool (e.g. the plugin's), so voices' delays pack together
+	template<>
+	class Delay<0> : public Modifier {
 	protected:
-		buffer buffer;
-		const int size;
+		std::shared_ptr<float> storage;
+		float* buffer = nullptr;
+		int mask = 0;
+		float time = 1;
+		int position = 0;
+		int written = 0;	// samples written since the last clear (only these can be non-zero)
 	public:
-		Wavetable(int size = 2048) : buffer(size), size(size)/*, Oscillator((float)size)*/ { }
+		Delay() { }
+		Delay(int capacity) { resize(capacity); }
+
+		// copies get their own storage (from the current Pool) holding the same contents
+		Delay(const Delay& source) : Modifier(source) { copy(source); }
+		Delay& operator=(const Delay& source) {
+			if (this != &source) {
+				Modifier::operator=(source);
+				copy(source);
+			}
+			return *this;
+		}
 
-		template<typename TYPE>
-		Wavetable(TYPE oscillator, int size = 2048) : buffer(size), size(size) {
-			operator=(oscillator);
+		// allocates (and clears) storage for at least [capacity] samples (not on the audio thread)
+		void resize(int capacity) {
+			int size = 1;
+			while (size < capacity)
+				size <<= 1;
+			storage = Pool::current().allocate(size);
+			buffer = storage.get();
+			mask = size - 1;
+			position = 0;
+			written = size;
+			clear();
 		}
-		
-		signal& operator[](int index) {
-			return buffer[index];
+
+		int capacity() const { return mask + 1; }
+
+	protected:
+		void copy(const Delay& source) {
+			if (source.buffer) {
+				if (!buffer || capacity() != source.capacity()) {
+					storage = Pool::current().allocate(source.capacity());
+					buffer = storage.get();
+					mask = source.mask;
+				}
+				memcpy(buffer, source.buffer, sizeof(float) * capacity());
+			} else {
+				storage.reset();
+				buffer = nullptr;
+				mask = 0;
+			}
+			time = source.time;
+			position = source.position;
+			written = source.written;
 		}
 
-		template<typename TYPE>
-		Wavetable& operator=(TYPE& oscillator) {
-			oscillator.set(fs / size);
-			for (int s = 0; s < size; s++)
-				buffer[s] = oscillator;
-			return *this;
+	public:
+
+		// zeroes the line (cost proportional to the samples written since the last clear)
+		void clear() {
+			const int start = position - written;
+			if (start >= 0) {
+				memset(&buffer[start], 0, sizeof(float) * written);
+			} else {
+				memset(buffer, 0, sizeof(float) * position);
+				memset(&buffer[capacity() + start], 0, sizeof(float) * -start);
+			}
+			written = 0;
 		}
 
-		virtual void set(param frequency) override {
-			Oscillator::frequency = frequency;
-			increment = frequency * (size / fs);
+		void operator<<(const signal& input) override {
+			buffer[position] = Delay::in = input;
+			position = (position + 1) & mask;
+			if (written <= mask)
+				written++;
 		}
 
-		virtual void set(param frequency, param phase) override {
-			position = phase * float(size);
-			set(frequency);
+		signal tap(float delay) const {
+			const float read = (float)(position - 1) - delay;
+			const float f = floorf(read);
+			delay = read - f;
+
+			const int i = (int)f & mask;
+			const int j = (i + 1) & mask;
+
+			return buffer[i] * (1.f - delay) + buffer[j] * delay;
 		}
 
-		virtual void set(relative phase) override {
-			
-			offset = phase * float(size);
+		signal& operator>>(signal& destination) override {
+			return destination = out = tap(time);
 		}
 
-		virtual void set(param frequency, relative phase) override {
-			set(frequency);
-			set(phase);
+		virtual operator signal () override {
+			return out = tap(time);
 		}
 
-		void process() override {
-			position += { increment, size };
-			out = buffer[position + offset /*klang::increment(offset, size)*/];
+		virtual void process() override {
+			operator<<(in);
+			out = tap(time);
+		}
+
+		virtual void process(const signal* inputs, signal* outputs, int samples) override {
+			for (int s = 0; s < samples; s++) {
+				Delay::operator<<(inputs[s]);
+				outputs[s] = tap(time);
+			}
+			if (samples)
+				out = outputs[samples - 1];
 		}
-	};
 
-	class Osc : public Oscillator {
-		std::unique_ptr<Oscillator> osc;
+		virtual void set(param delay) override {
+			assert(buffer && delay <= capacity() - 1);
+			Delay::time = delay;
+		}
+	};
 
+	// multi-tap delay (e.g. chorus, flanger, combs): TAPS interpolated taps per sample, read a block at a time
+	// - interpolation: Linear, Allpass (first-order; flat magnitude), Lagrange (3rd order) or Cubic (hermite)
+	// - each block is written first, then every tap reads its whole block (fixed delays: a 4-point FIR over
+	//   contiguous samples; modulated delays: AVX2 gathers, 8 samples at a time)
+	// - delays are clamped to [2, capacity - BLOCK - 3] samples (or from 0 for Linear); per-tap outputs in taps[]
+	template<int TAPS>
+	class MultiTap : public Delay<> {
 	public:
-		template<typename TYPE>
-		void set(TYPE) {
-			osc = new TYPE();
-			osc->set(frequency, position);
+		enum Interpolation { Linear, Allpass, Lagrange, Cubic };
+		static constexpr int BLOCK = 64;	// samples written ahead of the reads
+
+		Interpolation interpolation;
+		float taps[TAPS] = { 0 };	// (last output of each tap)
+
+		MultiTap(int capacity, Interpolation interpolation = Linear) : Delay<>(capacity + BLOCK + 3), interpolation(interpolation) {
+			for (int k = 0; k < TAPS; k++)
+				setTap(k, float(k + 1));
 		}
 
-		void set(param frequency) {
-			Oscillator::set(frequency);
-			osc->set(frequency);
+		void setTap(int tap, float delay, float gain = 1.f) {
+			assert(tap >= 0 && tap < TAPS && delay <= maximum());
+			times[tap] = delay;
+			gains[tap] = gain;
 		}
 
-		void set(param frequency, param phase) {
-			Oscillator::set(frequency, phase);
-			osc->set(frequency, phase);
+		void clear() {
+			Delay<>::clear();
+			std::fill(std::begin(state), std::end(state), 0.f);
 		}
-	};
 
-	// Models a changing value (e.g. amplitude) over time (in seconds) using breakpoints (time, value)
-	class Envelope : public Generator {
-		using Generator::set;
+		// (signal flow as a Modifier: in >> multitap >> out)
+		void operator<<(const signal& input) override { in = input; }
+		signal& operator>>(signal& destination) override { process(); return destination = out; }
+		operator signal() override { process(); return out; }
 
-	public:
-		// Abstract envelope ramp type (override to support different point-to-point trajectories)
-		struct Ramp : public Generator {
-			float target;
-			float rate;
-			bool active = false;
-		public:
+		// out = sum of gain x tap
+		void process() override {
+			process(&in, &out, 1);
+		}
 
-			// Create a null ramp (full signal)
-			Ramp(float value = 1.f) {
-				setValue(value);
+		void process(const signal* inputs, signal* outputs, int samples) override {
+			switch (interpolation) {
+			case Linear:	render<Linear>(inputs, outputs, samples); break;
+			case Allpass:	render<Allpass>(inputs, outputs, samples); break;
+			case Lagrange:	render<Lagrange>(inputs, outputs, samples); break;
+			case Cubic:		render<Cubic>(inputs, outputs, samples); break;
 			}
-
-			// Create a ramp from start to target over time (in seconds)
-			Ramp(float start, float target, float time) {
-				setValue(start);
-				setTarget(target);
-				setTime(time);
+			if (samples) {
+				in = inputs[samples - 1];
+				out = outputs[samples - 1];
 			}
+		}
 
-			virtual ~Ramp() { }
-
-			// Is ramp currently processing (ramping)?
-			bool isActive() const {
-				return active;
+		// per-tap outputs (outputs[tap][sample]), with optional per-sample delays (delays[tap][sample]; e.g. modulated)
+		void process(const signal* inputs, float* const* outputs, int samples, const float* const* delays = nullptr) {
+			switch (interpolation) {
+			case Linear:	render<Linear>(inputs, outputs, samples, delays); break;
+			case Allpass:	render<Allpass>(inputs, outputs, samples, delays); break;
+			case Lagrange:	render<Lagrange>(inputs, outputs, samples, delays); break;
+			case Cubic:		render<Cubic>(inputs, outputs, samples, delays); break;
 			}
+			if (samples)
+				in = inputs[samples - 1];
+		}
 
-			// Set a new target (retains rate)
-			virtual void setTarget(float target) {
-				Ramp::target = target;
-				active = (out != target);
+	protected:
+		float times[TAPS];
+		float gains[TAPS];
+		float state[TAPS] = { 0 };	// allpass outputs (per tap)
+
+		float minimum() const { return interpolation == Linear ? 0.f : 2.f; }
+		float maximum() const { return float(capacity() - BLOCK - 3); }
+
+		// writes a block (returns the write index of its first sample)
+		int write(const signal* inputs, int samples) {
+			const int start = position;
+			for (int s = 0; s < samples; s++)
+				Delay<>::operator<<(inputs[s]);
+			return start;
+		}
+
+		template<Interpolation MODE>
+		void render(const signal* inputs, signal* outputs, int samples) {
+			alignas(32) float y[BLOCK];
+			for (int offset = 0; offset < samples; offset += BLOCK) {
+				const int n = std::min(BLOCK, samples - offset);
+				const int start = write(&inputs[offset], n);
+				float* mix = (float*)&outputs[offset];
+				std::fill(mix, mix + n, 0.f);
+				for (int k = 0; k < TAPS; k++) {
+					read<MODE>(k, start, times[k], y, n);
+					for (int s = 0; s < n; s++)
+						mix[s] += gains[k] * y[s];
+					taps[k] = y[n - 1];
+				}
 			}
+		}
 
-			// Immediately jump to value (disables ramp)
-			virtual void setValue(float value) {
-				out = value;
-				Ramp::target = value;
-				active = false;
+		template<Interpolation MODE>
+		void render(const signal* inputs, float* const* outputs, int samples, const float* const* delays) {
+			for (int offset = 0; offset < samples; offset += BLOCK) {
+				const int n = std::min(BLOCK, samples - offset);
+				const int start = write(&inputs[offset], n);
+				for (int k = 0; k < TAPS; k++) {
+					if (delays)
+						read<MODE>(k, start, &delays[k][offset], &outputs[k][offset], n);
+					else
+						read<MODE>(k, start, times[k], &outputs[k][offset], n);
+					taps[k] = outputs[k][offset + n - 1];
+				}
 			}
+		}
 
-			// Set rate of change (per sample)
-			virtual void setRate(float rate) { Ramp::rate = rate; }
-
-			// Set rate of change (by duration)
-			virtual void setTime(float time) { Ramp::rate = time ? 1.f / (time * fs) : 0; }
+		// 4-point weights (for the samples before, at, after and two after the read position)
+		template<Interpolation MODE>
+		static void weights(float f, float* w) {
+			if constexpr (MODE == Linear) {
+				w[0] = 0;	w[1] = 1.f - f;	w[2] = f;	w[3] = 0;
+			} else if constexpr (MODE == Lagrange) {
+				w[0] = -f * (f - 1.f) * (f - 2.f) * (1.f / 6.f);
+				w[1] = (f + 1.f) * (f - 1.f) * (f - 2.f) * 0.5f;
+				w[2] = -(f + 1.f) * f * (f - 2.f) * 0.5f;
+				w[3] = (f + 1.f) * f * (f - 1.f) * (1.f / 6.f);
+			} else { // cubic hermite (catmull-rom)
+				const float f2 = f * f, f3 = f2 * f;
+				w[0] = -0.5f * f + f2 - 0.5f * f3;
+				w[1] = 1.f - 2.5f * f2 + 1.5f * f3;
+				w[2] = 0.5f * f + 2.f * f2 - 1.5f * f3;
+				w[3] = -0.5f * f2 + 0.5f * f3;
+			}
+		}
 
-			// Return the current output and advanced the ramp
-			virtual signal operator++(int) = 0;
+		// first-order allpass interpolation (fractional delay kept in [0.5, 1.5) for a well-damped filter)
+		float allpass(int k, int i, float f) {
+			const bool late = f > 0.5f;
+			const float newer = buffer[(i + (late ? 2 : 1)) & mask];
+			const float older = buffer[(i + (late ? 1 : 0)) & mask];
+			const float fraction = (late ? 2.f : 1.f) - f;
+			const float eta = (1.f - fraction) / (1.f + fraction);
+			return state[k] = eta * (newer - state[k]) + older;
+		}
+
+		// one tap at a fixed delay (sample s of the block reads between i + s and i + s + 1, at f)
+		// (split from the delay, not the write index, so the precision does not depend on position)
+		template<Interpolation MODE>
+		void read(int k, int start, float delay, float* y, int n) {
+			const float d = std::min(std::max(delay, minimum()), maximum());
+			const int whole = (int)d;	// (d >= 0, so truncation is floor)
+			const float f = 1.f - (d - (float)whole);	// (in (0, 1])
+			const int i = start - whole - 1;
+
+			if constexpr (MODE == Allpass) {
+				for (int s = 0; s < n; s++)
+					y[s] = allpass(k, i + s, f);
+			} else {
+				float w[4];
+				weights<MODE>(f, w);
+				const int first = (i - 1) & mask;
+				if (first + n + 3 <= capacity()) {
+					// (contiguous: a 4-point FIR with fixed weights)
+					const float* x = &buffer[first];
+					for (int s = 0; s < n; s++)
+						y[s] = w[0] * x[s] + w[1] * x[s + 1] + w[2] * x[s + 2] + w[3] * x[s + 3];
+				} else {
+					for (int s = 0; s < n; s++) {
+						const int j = i + s;
+						y[s] = w[0] * buffer[(j - 1) & mask] + w[1] * buffer[j & mask] + w[2] * buffer[(j + 1) & mask] + w[3] * buffer[(j + 2) & mask];
+					}
+				}
+			}
+		}
 
-			void process() override { /* do nothing -> only process on ++ */ }
-		};
+		// one tap with per-sample delays
+		template<Interpolation MODE>
+		void read(int k, int start, const float* delays, float* y, int n) {
+			const float lo = minimum(), hi = maximum();
+			int s = 0;
+#if defined(KLANG_AVX2)
+			if constexpr (MODE != Allpass) {
+				const __m256i m = _mm256_set1_epi32(mask);
+				const __m256 one = _mm256_set1_ps(1.f), half = _mm256_set1_ps(0.5f);
+				for (; s + 8 <= n; s += 8) {
+					const __m256 d = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(delays + s), _mm256_set1_ps(lo)), _mm256_set1_ps(hi));
+					const __m256 whole = _mm256_floor_ps(d);
+					const __m256 f = _mm256_sub_ps(one, _mm256_sub_ps(d, whole));
+					const __m256i i = _mm256_sub_epi32(_mm256_add_epi32(_mm256_set1_epi32(start + s - 1), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)), _mm256_cvttps_epi32(whole));
+					auto at = [&](int offset) { return _mm256_i32gather_ps(buffer, _mm256_and_si256(_mm256_add_epi32(i, _mm256_set1_epi32(offset)), m), 4); };
+
+					const __m256 y0 = at(0), y1 = at(1);
+					__m256 out;
+					if constexpr (MODE == Linear) {
+						out = _mm256_add_ps(y0, _mm256_mul_ps(_mm256_sub_ps(y1, y0), f));
+					} else {
+						const __m256 ym = at(-1), y2 = at(2);
+						const __m256 f2 = _mm256_mul_ps(f, f), f3 = _mm256_mul_ps(f2, f);
+						__m256 wm, w0, w1, w2;
+						if constexpr (MODE == Lagrange) {
+							const __m256 sixth = _mm256_set1_ps(1.f / 6.f);
+							const __m256 fp1 = _mm256_add_ps(f, one), fm1 = _mm256_sub_ps(f, one), fm2 = _mm256_sub_ps(f, _mm256_set1_ps(2.f));
+							const __m256 a = _mm256_mul_ps(fm1, fm2), b = _mm256_mul_ps(fp1, f);
+							wm = _mm256_mul_ps(_mm256_mul_ps(f, a), _mm256_set1_ps(-1.f / 6.f));
+							w0 = _mm256_mul_ps(_mm256_mul_ps(fp1, a), half);
+							w1 = _mm256_mul_ps(_mm256_mul_ps(b, fm2), _mm256_set1_ps(-0.5f));
+							w2 = _mm256_mul_ps(_mm256_mul_ps(b, fm1), sixth);
+						} else { // cubic hermite (catmull-rom)
+							wm = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-0.5f), _mm256_add_ps(f, f3)), f2);
+							w0 = _mm256_add_ps(one, _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-2.5f), f2), _mm256_mul_ps(_mm256_set1_ps(1.5f), f3)));
+							w1 = _mm256_add_ps(_mm256_mul_ps(half, f), _mm256_sub_ps(_mm256_mul_ps(_mm256_set1_ps(2.f), f2), _mm256_mul_ps(_mm256_set1_ps(1.5f), f3)));
+							w2 = _mm256_mul_ps(half, _mm256_sub_ps(f3, f2));
+						}
+						out = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(wm, ym), _mm256_mul_ps(w0, y0)), _mm256_add_ps(_mm256_mul_ps(w1, y1), _mm256_mul_ps(w2, y2)));
+					}
+					_mm256_storeu_ps(y + s, out);
+				}
+			}
+#endif
+			for (; s < n; s++) {
+				const float d = std::min(std::max(delays[s], lo), hi);
+				const int whole = (int)d;
+				const float f = 1.f - (d - (float)whole);
+				const int i = start + s - whole - 1;
+				if constexpr (MODE == Allpass) {
+					y[s] = allpass(k, i, f);
+				} else if constexpr (MODE == Linear) {
+					const float y0 = buffer[i & mask];
+					y[s] = y0 + (buffer[(i + 1) & mask] - y0) * f;
+				} else {
+					float w[4];
+					weights<MODE>(f, w);
+					y[s] = w[0] * buffer[(i - 1) & mask] + w[1] * buffer[i & mask] + w[2] * buffer[(i + 1) & mask] + w[3] * buffer[(i + 2) & mask];
+				}
+			}
+		}
+	};
 
-		// Default (linear) ramp implementation
-		struct Linear : public Ramp {
+	// dot product (SIMD; any length)
+	inline float dot(const float* a, const float* b, int n) {
+		int i = 0;
+		float sum = 0;
+#if defined(KLANG_AVX)
+		__m256 acc = _mm256_setzero_ps();
+		for (; i + 8 <= n; i += 8)
+			acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i)));
+		__m128 acc4 = _mm_add_ps(_mm256_castps256_ps128(acc), _mm256_extractf128_ps(acc, 1));
+#elif defined(KLANG_SSE)
+		__m128 acc4 = _mm_setzero_ps();
+#endif
+#if defined(KLANG_SSE)
+		for (; i + 4 <= n; i += 4)
+			acc4 = _mm_add_ps(acc4, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+		acc4 = _mm_add_ps(acc4, _mm_movehl_ps(acc4, acc4));
+		acc4 = _mm_add_ss(acc4, _mm_shuffle_ps(acc4, acc4, 1));
+		sum = _mm_cvtss_f32(acc4);
+#elif defined(KLANG_NEON)
+		float32x4_t acc4 = vdupq_n_f32(0.f);
+		for (; i + 4 <= n; i += 4)
+			acc4 = vmlaq_f32(acc4, vld1q_f32(a + i), vld1q_f32(b + i));
+		sum = vaddvq_f32(acc4);
+#endif
+		for (; i < n; i++)
+			sum += a[i] * b[i];
+		return sum;
+	}
 
-			// Return the current output and process the next
-			signal operator++(int) override {
-				const signal output = out;
+	// modified Bessel function of the first kind, order 0 (for Kaiser windows)
+	inline double bessel(double x) {
+		double sum = 1, term = 1;
+		for (int k = 1; k < 32; k++) {
+			term *= (x / (2 * k)) * (x / (2 * k));
+			sum += term;
+		}
+		return sum;
+	}
 
-				if (active) {
-					if (target > out) {
-						out += rate;
-						if (out >= target) {
-							out = target;
-							active = false;
-						}
-					}
-					else {
-						out -= rate;
-						if (out <= target) {
-							out = target;
-							active = false;
-						}
+	// fast Fourier transform (radix-2, power-of-two sizes; SIMD butterflies)
+	// - twiddle and bit-reversal tables are shared by all transforms of the same size
+	// - real transforms use a half-size complex transform; spectra are split (re[], im[]) with size/2 + 1 bins
+	// - forward transforms are unscaled; inverse transforms scale by 1/size (so inverse(forward(x)) = x)
+	// - no allocation after construction (safe on the audio thread)
+	class FFT {
+	public:
+		struct Tables {
+			std::vector<float> cosine, sine;		// e^(-i pi k / h) for each butterfly span h (at [h - 1, 2h - 1))
+			std::vector<int> reversal[2];			// bit-reversal permutations (size, size/2)
+
+			Tables(int size) : cosine(size - 1), sine(size - 1) {
+				for (int h = 1; h < size; h <<= 1) {
+					for (int k = 0; k < h; k++) {
+						const double w = 3.1415926535897932384626433832795 * k / h;
+						cosine[h - 1 + k] = (float)cos(w);
+						sine[h - 1 + k] = (float)-sin(w);
 					}
 				}
+				reversal[0] = permutation(size);
+				reversal[1] = permutation(size / 2);
+			}
 
-				return output;
+			static std::vector<int> permutation(int n) {
+				std::vector<int> p(n);
+				int bits = 0;
+				while ((1 << bits) < n) bits++;
+				for (int i = 0; i < n; i++) {
+					int r = 0;
+					for (int b = 0; b < bits; b++)
+						r |= ((i >> b) & 1) << (bits - 1 - b);
+					p[i] = r;
+				}
+				return p;
 			}
 		};
 
-		enum Stage { Sustain, Release, Off };
-		enum Mode { Time, Rate };
+		// returns the shared tables for a size (built on first use, released when no longer referenced)
+		static std::shared_ptr<const Tables> get(int size) {
+			static std::mutex mutex;
+			static std::map<int, std::weak_ptr<const Tables>> cache;
 
-		// Envelope point type
-		struct Point {
-			float x, y;
+			std::lock_guard<std::mutex> lock(mutex);
+			std::weak_ptr<const Tables>& entry = cache[size];
+			std::shared_ptr<const Tables> tables = entry.lock();
+			if (!tables)
+				entry = tables = std::make_shared<const Tables>(size);
+			return tables;
+		}
 
-			Point() : x(0), y(0) { }
-			
-			template<typename T1, typename T2>
-			Point(T1 x, T2 y) : x(float(x)), y(float(y)) { }
-		};
+		const int size;
 
-		// Linked-list of points (for inline initialisation)
-		struct Points : public Point {
-			Points(float x, float y) {
-				Point::x = x;
-				Point::y = y;
-				next = NULL;
+		FFT(int size) : size(size), tables((assert(size >= 4 && (size & (size - 1)) == 0), get(size))), scratch(size) { }
+
+		// complex transform of size points (in place)
+		void transform(float* re, float* im, bool inverse = false) const {
+			complex(re, im, size, inverse);
+			if (inverse) {
+				const float scale = 1.f / size;
+				for (int i = 0; i < size; i++) {
+					re[i] *= scale;
+					im[i] *= scale;
+				}
 			}
-			~Points() {
-				delete next;
+		}
+
+		// real transform (size samples to size/2 + 1 bins)
+		void forward(const float* input, float* re, float* im) {
+			const int M = size / 2;
+			const float* cosine = &tables->cosine[M - 1];	// e^(-2 pi i k / size)
+			const float* sine = &tables->sine[M - 1];
+			float* zr = scratch.data();
+			float* zi = zr + M;
+			for (int k = 0; k < M; k++) {
+				zr[k] = input[2 * k];
+				zi[k] = input[2 * k + 1];
+			}
+			complex(zr, zi, M, false);
+
+			// split the even/odd spectra: X[k] = E[k] + W^k O[k]
+			for (int k = 0; k <= M / 2; k++) {
+				const int j = (M - k) & (M - 1);
+				const float er = 0.5f * (zr[k] + zr[j]), ei = 0.5f * (zi[k] - zi[j]);
+				const float or_ = 0.5f * (zi[k] + zi[j]), oi = 0.5f * (zr[j] - zr[k]);
+				const float wr = cosine[k], wi = sine[k];
+				const float tr = or_ * wr - oi * wi, ti = or_ * wi + oi * wr;
+				re[k] = er + tr;	im[k] = ei + ti;
+				re[M - k] = er - tr;	im[M - k] = ti - ei;	// (conjugate symmetry: X[M-k] = conj(E[k] - W^k O[k]))
 			}
+			im[0] = im[M] = 0;
+		}
+
+		// inverse real transform (size/2 + 1 bins to size samples)
+		void inverse(const float* re, const float* im, float* output) {
+			const int M = size / 2;
+			const float* cosine = &tables->cosine[M - 1];
+			const float* sine = &tables->sine[M - 1];
+			float* zr = scratch.data();
+			float* zi = zr + M;
+
+			// merge into the even/odd spectra: Z[k] = E[k] + i O[k]
+			for (int k = 0; k <= M / 2; k++) {
+				const int j = M - k;
+				const float er = 0.5f * (re[k] + re[j]), ei = 0.5f * (im[k] - im[j]);
+				const float dr = 0.5f * (re[k] - re[j]), di = 0.5f * (im[k] + im[j]);
+				const float wr = cosine[k], wi = -sine[k];	// W^-k
+				const float or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+				zr[k] = er - oi;	zi[k] = ei + or_;
+				if (k && k != j) {
+					// Z[M-k] = conj(E[k]) + i conj(O[k])
+					zr[j] = er + oi;	zi[j] = or_ - ei;
+				}
+			}
+			complex(zr, zi, M, true);
 
-			Points& operator()(float x, float y) {
-				last().next = new Points(x, y);
-				return *this;
+			const float scale = 1.f / M;
+			for (int k = 0; k < M; k++) {
+				output[2 * k] = zr[k] * scale;
+				output[2 * k + 1] = zi[k] * scale;
 			}
+		}
 
-			Points& last() {
-				return next ? next->last() : *this;
+	protected:
+		std::shared_ptr<const Tables> tables;
+		std::vector<float> scratch;
+
+		// complex transform of n points (n = size or size/2), in place, unscaled
+		// (the inverse swaps re/im on the way in and out, so only forward butterflies are needed)
+		void complex(float* re, float* im, int n, bool inverse) const {
+			const std::vector<int>& p = tables->reversal[n == size ? 0 : 1];
+			for (int i = 0; i < n; i++) {
+				const int j = p[i];
+				if (j > i) {
+					std::swap(re[i], re[j]);
+					std::swap(im[i], im[j]);
+				}
+			}
+			if (inverse)
+				butterflies(im, re, n);
+			else
+				butterflies(re, im, n);
+		}
+
+		void butterflies(float* re, float* im, int n) const {
+			// 2 points (the half-size transform of a 4-point real FFT): a single radix-2 butterfly
+			if (n == 2) {
+				const float br = re[1], bi = im[1];
+				re[1] = re[0] - br;	im[1] = im[0] - bi;
+				re[0] += br;		im[0] += bi;
+				return;
 			}
 
-			int count() const {
-				return next ? 1 + next->count() : 1;
+			// first two passes as radix-4 (twiddles 1 and -i; no multiplies)
+			for (int i = 0; i < n; i += 4) {
+				const float ar = re[i] + re[i + 1], ai = im[i] + im[i + 1];
+				const float br = re[i] - re[i + 1], bi = im[i] - im[i + 1];
+				const float cr = re[i + 2] + re[i + 3], ci = im[i + 2] + im[i + 3];
+				const float dr = im[i + 2] - im[i + 3], di = re[i + 3] - re[i + 2];	// (-i)(x2 - x3)
+				re[i] = ar + cr;		im[i] = ai + ci;
+				re[i + 1] = br + dr;	im[i + 1] = bi + di;
+				re[i + 2] = ar - cr;	im[i + 2] = ai - ci;
+				re[i + 3] = br - dr;	im[i + 3] = bi - di;
 			}
 
-			Points* next;
-		};
+			for (int h = 4; h < n; h <<= 1) {
+				const float* wr = &tables->cosine[h - 1];
+				const float* wi = &tables->sine[h - 1];
+				for (int i = 0; i < n; i += 2 * h) {
+					float* ar = re + i; float* ai = im + i;
+					float* br = ar + h; float* bi = ai + h;
+					int k = 0;
+#if defined(KLANG_AVX)
+					for (; k + 8 <= h; k += 8) {
+						const __m256 cr = _mm256_loadu_ps(wr + k), ci = _mm256_loadu_ps(wi + k);
+						const __m256 xr = _mm256_loadu_ps(br + k), xi = _mm256_loadu_ps(bi + k);
+						const __m256 tr = _mm256_sub_ps(_mm256_mul_ps(xr, cr), _mm256_mul_ps(xi, ci));
+						const __m256 ti = _mm256_add_ps(_mm256_mul_ps(xr, ci), _mm256_mul_ps(xi, cr));
+						const __m256 yr = _mm256_loadu_ps(ar + k), yi = _mm256_loadu_ps(ai + k);
+						_mm256_storeu_ps(br + k, _mm256_sub_ps(yr, tr));	_mm256_storeu_ps(bi + k, _mm256_sub_ps(yi, ti));
+						_mm256_storeu_ps(ar + k, _mm256_add_ps(yr, tr));	_mm256_storeu_ps(ai + k, _mm256_add_ps(yi, ti));
+					}
+#endif
+#if defined(KLANG_SSE)
+					for (; k + 4 <= h; k += 4) {
+						const __m128 cr = _mm_loadu_ps(wr + k), ci = _mm_loadu_ps(wi + k);
+						const __m128 xr = _mm_loadu_ps(br + k), xi = _mm_loadu_ps(bi + k);
+						const __m128 tr = _mm_sub_ps(_mm_mul_ps(xr, cr), _mm_mul_ps(xi, ci));
+						const __m128 ti = _mm_add_ps(_mm_mul_ps(xr, ci), _mm_mul_ps(xi, cr));
+						const __m128 yr = _mm_loadu_ps(ar + k), yi = _mm_loadu_ps(ai + k);
+						_mm_storeu_ps(br + k, _mm_sub_ps(yr, tr));	_mm_storeu_ps(bi + k, _mm_sub_ps(yi, ti));
+						_mm_storeu_ps(ar + k, _mm_add_ps(yr, tr));	_mm_storeu_ps(ai + k, _mm_add_ps(yi, ti));
+					}
+#elif defined(KLANG_NEON)
+					for (; k + 4 <= h; k += 4) {
+						const float32x4_t cr = vld1q_f32(wr + k), ci = vld1q_f32(wi + k);
+						const float32x4_t xr = vld1q_f32(br + k), xi = vld1q_f32(bi + k);
+						const float32x4_t tr = vmlsq_f32(vmulq_f32(xr, cr), xi, ci);
+						const float32x4_t ti = vmlaq_f32(vmulq_f32(xr, ci), xi, cr);
+						const float32x4_t yr = vld1q_f32(ar + k), yi = vld1q_f32(ai + k);
+						vst1q_f32(br + k, vsubq_f32(yr, tr));	vst1q_f32(bi + k, vsubq_f32(yi, ti));
+						vst1q_f32(ar + k, vaddq_f32(yr, tr));	vst1q_f32(ai + k, vaddq_f32(yi, ti));
+					}
+#endif
+					for (; k < h; k++) {
+						const float tr = br[k] * wr[k] - bi[k] * wi[k];
+						const float ti = br[k] * wi[k] + bi[k] * wr[k];
+						br[k] = ar[k] - tr;	bi[k] = ai[k] - ti;
+						ar[k] += tr;		ai[k] += ti;
+					}
+				}
+			}
+		}
+	};
 
-		// Envelope loop (between two points)
-		struct Loop {
-			Loop(int from = -1, int to = -1) : start(from), end(to) {}
+	// partitioned convolution (e.g. cabinet or reverb impulse responses)
+	// - zero latency: the first [block] taps run as a direct FIR; the rest as overlap-save FFT partitions
+	// - Uniform: every partition is [block] long (even CPU load; cost grows with IR length)
+	// - NonUniform: partition sizes grow 8x per stage (e.g. 64, 512, 4096; far cheaper for long IRs,
+	//   but each stage does its FFT work when its block completes, so CPU load is less even)
+	class Convolver : public Modifier {
+	public:
+		enum Partitioning { Uniform, NonUniform };
+
+		Convolver() { }
+		Convolver(const buffer& ir, int block = 64, Partitioning partitioning = Uniform) { load(ir, block, partitioning); }
+
+		// load an impulse response (block: power-of-two partition size; also the direct FIR length)
+		void load(const buffer& ir, int block = 64, Partitioning partitioning = Uniform) {
+			assert(block >= 4 && (block & (block - 1)) == 0);
+			const float* h = (const float*)&ir[0];
+			const int length = ir.size;
+
+			head.assign(block, 0.f);
+			for (int i = 0; i < std::min(block, length); i++)
+				head[block - 1 - i] = h[i]; // (reversed, for the dot product)
+			history.assign(2 * block, 0.f);
+			position = 0;
+
+			stages.clear();
+			for (int size = block, offset = block; offset < length; offset += stages.back()->span()) {
+				const bool last = partitioning == Uniform || offset * 8 >= length;
+				const int end = last ? length : offset * 8;
+				stages.emplace_back(new Stage(h, length, offset, end - offset, size));
+				if (partitioning == NonUniform)
+					size *= 8;
+			}
+		}
 
-			void set(int from, int to) { start = from; end = to; }
-			void reset() { start = end = -1; }
+		// latency (in samples; always zero)
+		int latency() const { return 0; }
 
-			bool isActive() const { return start != -1 && end != -1; }
+		void reset() {
+			std::fill(history.begin(), history.end(), 0.f);
+			for (auto& stage : stages)
+				stage->reset();
+		}
 
-			int start;
-			int end;
-		};
+		void process() override {
+			out = tick(in);
+		}
 
-		// Default Envelope (full signal)
-		Envelope() : ramp(new Linear()) {										set(Points(0.f, 1.f));	}
+		void process(const signal* inputs, signal* outputs, int samples) override {
+			for (int s = 0; s < samples; s++)
+				outputs[s] = tick(inputs[s]);
+			if (samples) {
+				in = inputs[samples - 1];
+				out = outputs[samples - 1];
+			}
+		}
 
-		// Creates a new envelope from a list of points, e.g. Envelope env = Envelope::Points(0,1)(1,0);
-		Envelope(const Points& points) : ramp(new Linear()) {					set(points);			}
+	protected:
+		// uniformly partitioned overlap-save convolution of an IR segment [offset, offset + length)
+		// (offset >= size, so the output for the next block only needs input that has already arrived)
+		struct Stage {
+			const int size, delay, partitions, bins;
+			FFT fft;
+			std::vector<float> input, output, time;
+			std::vector<float> H, X, accumulator;	// spectra (split re/im per partition)
+			int fill = 0, newest = 0;
+
+			Stage(const float* ir, int irLength, int offset, int length, int size)
+			: size(size), delay(offset / size), partitions((length + size - 1) / size), bins(size + 1), fft(2 * size),
+			  input(2 * size), output(size), time(2 * size), H(2 * bins * partitions), X(2 * bins * (delay - 1 + partitions)), accumulator(2 * bins) {
+				for (int p = 0; p < partitions; p++) {
+					std::fill(time.begin(), time.end(), 0.f);
+					for (int i = 0; i < size; i++) {
+						const int t = offset + p * size + i;
+						if (t < irLength)
+							time[i] = ir[t];
+					}
+					fft.forward(time.data(), &H[2 * bins * p], &H[2 * bins * p + bins]);
+				}
+			}
 
-		// Creates a new envelope from a list of points, e.g. Envelope env = { { 0,1 }, { 1,0 } };
-		Envelope(std::initializer_list<Point> points) : ramp(new Linear()) {	set(points);			}
+			int span() const { return partitions * size; }
 
-		// Creates a copy of an envelope from another envelope
-		Envelope(const Envelope& in) : ramp(new Linear()) {						set(in.points);			}
+			void reset() {
+				std::fill(input.begin(), input.end(), 0.f);
+				std::fill(output.begin(), output.end(), 0.f);
+				std::fill(X.begin(), X.end(), 0.f);
+				fill = 0;
+			}
 
-		virtual ~Envelope() { }
+			float tick(float x) {
+				const float y = output[fill];
+				input[size + fill] = x;
+				if (++fill == size) {
+					fill = 0;
+					update();
+				}
+				return y;
+			}
 
-		// Checks if the envelope is at a specified stage (Sustain, Release, Off)
-		bool operator==(Stage stage) const { return Envelope::stage == stage; }
-		bool operator!=(Stage stage) const { return Envelope::stage != stage; }
+			// transform the latest input and compute the next block of output
+			void update() {
+				const int slots = delay - 1 + partitions;
+				newest = newest ? newest - 1 : slots - 1;
+				fft.forward(input.data(), &X[2 * bins * newest], &X[2 * bins * newest + bins]);
+				std::copy(input.begin() + size, input.end(), input.begin());
+
+				float* ar = accumulator.data();
+				float* ai = ar + bins;
+				std::fill(accumulator.begin(), accumulator.end(), 0.f);
+				for (int p = 0; p < partitions; p++) {
+					int slot = newest + delay - 1 + p;
+					if (slot >= slots) slot -= slots;
+					const float* xr = &X[2 * bins * slot];
+					const float* xi = xr + bins;
+					const float* hr = &H[2 * bins * p];
+					const float* hi = hr + bins;
+					for (int k = 0; k < bins; k++) {
+						ar[k] += xr[k] * hr[k] - xi[k] * hi[k];
+						ai[k] += xr[k] * hi[k] + xi[k] * hr[k];
+					}
+				}
 
-		operator float() const { return out; }
+				fft.inverse(ar, ai, time.data());
+				std::copy(time.begin() + size, time.end(), output.begin());
+			}
+		};
 
-		// assign points (without recreating envelope)
-		Envelope& operator=(std::initializer_list<Point> points) {
-			set(points);
-			return *this;
+		float tick(float x) {
+			const int block = (int)head.size();
+			history[position] = history[position + block] = x;
+			if (++position == block)
+				position = 0;
+
+			float y = dot(head.data(), &history[position], block);
+			for (auto& stage : stages)
+				y += stage->tick(x);
+			return y;
 		}
 
-		// Sets the envelope based on an array of points
-		void set(const std::vector<Point>& points) {
-			Envelope::points = points;
-			initialise();
+		std::vector<float> head, history;	// direct FIR (reversed taps; doubled circular history)
+		int position = 0;
+		std::vector<std::unique_ptr<Stage>> stages;
+	};
+
+	// short-time Fourier transform (windowed overlap-add spectral processing)
+	// - override spectrum() to read or modify each frame's bins (size/2 + 1, split re/im) in place
+	// - sqrt-Hann analysis and synthesis windows; hop = size / overlap (overlap >= 2)
+	// - latency: size samples; no allocation after construction
+	class STFT : public Modifier {
+	public:
+		const int size, hop, bins;
+
+		STFT(int size = 1024, int overlap = 4)
+		: size(size), hop(size / overlap), bins(size / 2 + 1), fft(size),
+		  window(size), history(size), overlap(size), frame(size), re(bins), im(bins) {
+			assert(overlap >= 2 && hop * overlap == size);
+			for (int n = 0; n < size; n++)
+				window[n] = (float)sqrt(0.5 - 0.5 * cos(2.0 * 3.1415926535897932384626433832795 * n / size));
+
+			// overlap-add gain (window^2 summed over overlapping frames; constant for periodic Hann)
+			double sum = 0;
+			for (int n = 0; n < size; n += hop)
+				sum += window[n] * window[n];
+			gain = float(1.0 / sum);
 		}
 
-		// Sets the envelope from a list of points, e.g. env.set( Envelope::Points(0,1)(1,0) );
-		void set(const Points& point){
-			points.clear();
-            
-			const Points* pPoint = &point;
-			while(pPoint){
-				points.push_back(*pPoint);
-				pPoint = pPoint->next;
-			}
-            
-			initialise();
+		int latency() const { return size; }
+
+		void reset() {
+			std::fill(history.begin(), history.end(), 0.f);
+			std::fill(overlap.begin(), overlap.end(), 0.f);
+			fill = 0;
 		}
 
-		// Converts envelope points based on relative time to absolute time
-		void sequence() {
-			float time = 0.f;
-			for(Point& point : points) {
-				const float delta = point.x;
-				time += delta + 0.00001f;
-				point.x = time;
+		void process() override {
+			out = overlap[fill];
+			history[size - hop + fill] = in;
+			if (++fill == hop)
+				next();
+		}
+
+		void process(const signal* inputs, signal* outputs, int samples) override {
+			for (int s = 0; s < samples; ) {
+				const int n = std::min(hop - fill, samples - s);
+				for (int i = 0; i < n; i++) {
+					outputs[s + i] = overlap[fill + i];
+					history[size - hop + fill + i] = inputs[s + i];
+				}
+				s += n;
+				fill += n;
+				if (fill == hop)
+					next();
+			}
+			if (samples) {
+				in = inputs[samples - 1];
+				out = outputs[samples - 1];
 			}
-			initialise();
 		}
 
-		// Sets an envelope loop between two points
-		void setLoop(int startPoint, int endPoint){
-			if(startPoint >= 0 && endPoint < points.size())
-				loop.set(startPoint, endPoint);
-		}
+	protected:
+		// called once per hop with the frame's spectrum (re[bins], im[bins]; modify in place; default passes through)
+		virtual void spectrum(float*, float*, int) { }
+
+		// analyse, process and resynthesise one frame
+		void next() {
+			fill = 0;
+			for (int n = 0; n < size; n++)
+				frame[n] = history[n] * window[n];
+			fft.forward(frame.data(), re.data(), im.data());
+			spectrum(re.data(), im.data(), bins);
+			fft.inverse(re.data(), im.data(), frame.data());
+
+			// shift out the finished hop and add the new frame
+			std::copy(overlap.begin() + hop, overlap.end(), overlap.begin());
+			std::fill(overlap.end() - hop, overlap.end(), 0.f);
+			for (int n = 0; n < size; n++)
+				overlap[n] += frame[n] * window[n] * gain;
+			std::copy(history.begin() + hop, history.end(), history.begin());
+		}
+
+		FFT fft;
+		std::vector<float> window, history, overlap, frame, re, im;
+		float gain;
+		int fill = 0;
+	};
 
-		// Retrieve value at time (in seconds)
-		signal at(param time) {
-			if (points.empty()) return 0;
-			Point last = { 0, points[0].y };
-			for (const Point& point : points) {
-				if (point.x >= time) {
-					const float dx = point.x - last.x;
-					const float dy = point.y - last.y;
-					const float x = time - last.x;
-					return dx == 0 ? last.y : (last.y + x * dy / dx);
+	// oversampling wrapper (runs a Modifier at N x fs; e.g. waveshapers, high-index FM, saturating feedback loops)
+	// - N = 2, 4 or 8: cascaded polyphase half-band FIR stages (linear phase; images/aliases below -90 dB)
+	// - the modifier is constructed and set() at N x fs (call other fs-dependent methods inside a Rate scope)
+	// - latency() is fixed (host samples): 39 (2x), 45.5 (4x) or 47.75 (8x), plus the modifier's own
+	template<int N, typename MODIFIER>
+	class Oversample : public Modifier {
+		static_assert(N == 2 || N == 4 || N == 8, "Oversample: N must be 2, 4 or 8");
+		static constexpr int STAGES = N == 2 ? 1 : N == 4 ? 2 : 3;
+		static constexpr int BLOCK = 64;	// host samples per internal block
+
+		// polyphase half-band FIR (2K odd taps + 0.5 centre tap; Kaiser-windowed sinc)
+		// - upsample: even outputs are a 2K-tap FIR of the input; odd outputs are the delayed input
+		// - downsample: 2K-tap FIR of the even inputs + 0.5 x the delayed odd inputs
+		struct HalfBand {
+			const int K;
+			std::vector<float> taps;			// (symmetric, so no reversal needed)
+			std::vector<float> up, even, odd;	// histories, followed by the current block
+
+			HalfBand(int K, int block) : K(K), taps(2 * K), up(2 * K - 1 + block), even(2 * K - 1 + block), odd(K + block) {
+				const double beta = 10.0;
+				double sum = 0;
+				for (int p = 0; p < 2 * K; p++) {
+					const int m = 2 * p - (2 * K - 1);	// (odd offset from the centre tap)
+					const double r = double(m) / (2 * K);
+					const double sinc = sin(3.1415926535897932384626433832795 * m / 2) / (3.1415926535897932384626433832795 * m);
+					taps[p] = float(sinc * bessel(beta * sqrt(1 - r * r)) / bessel(beta));
+					sum += taps[p];
 				}
-				last = point;
+				for (float& tap : taps)
+					tap *= float(0.5 / sum); // (unity gain at DC)
 			}
-			return points.back().y;
+
+			// n inputs to 2n outputs
+			void upsample(const float* in, float* out, int n) {
+				float* x = up.data();
+				std::copy(in, in + n, x + 2 * K - 1);
+				for (int i = 0; i < n; i++) {
+					out[2 * i] = 2.f * dot(taps.data(), x + i, 2 * K);
+					out[2 * i + 1] = x[i + K];
+				}
+				std::copy(x + n, x + n + 2 * K - 1, x);
+			}
+
+			// 2n inputs to n outputs
+			void downsample(const float* in, float* out, int n) {
+				float* e = even.data();
+				float* o = odd.data();
+				for (int i = 0; i < n; i++) {
+					e[2 * K - 1 + i] = in[2 * i];
+					o[K + i] = in[2 * i + 1];
+				}
+				for (int i = 0; i < n; i++)
+					out[i] = dot(taps.data(), e + i, 2 * K) + 0.5f * o[i];
+				std::copy(e + n, e + n + 2 * K - 1, e);
+				std::copy(o + n, o + n + K, o);
+			}
+
+			void reset() {
+				std::fill(up.begin(), up.end(), 0.f);
+				std::fill(even.begin(), even.end(), 0.f);
+				std::fill(odd.begin(), odd.end(), 0.f);
+			}
+		};
+
+		// taps per stage (later stages run on an already band-limited signal, so need far fewer)
+		static int order(int stage) { return stage == 0 ? 20 : stage == 1 ? 7 : 5; }
+
+		static MODIFIER construct() {
+			Rate rate;
+			return MODIFIER();
 		}
 
-		//void set(param time) override {
-		//	setTargetValue(at(time), 1.f);
-		//}
-        
-		// Resets the envelope loop
-		void resetLoop(){
-			loop.reset();
-			if(stage == Sustain && (point+1) < points.size())
-				setTarget(points[point+1], points[point].x);
+	public:
+		// scales fs by N for its lifetime
+		struct Rate {
+			const float host;
+			Rate() : host(fs) { fs = host * N; }
+			~Rate() { fs = host; }
+		};
+
+		MODIFIER modifier;	// (runs at N x fs)
+
+		Oversample() : modifier(construct()) {
+			for (int s = 0; s < STAGES; s++) {
+				stages.emplace_back(order(s), BLOCK << s);
+				buffers[s].resize(BLOCK << s);
+			}
+			buffers[STAGES].resize(BLOCK * N);
+			result.resize(BLOCK * N);
 		}
-        
-		// Sets the current stage of the envelope
-		void setStage(Stage stage){ this->stage = stage; }
 
-		// Returns the current stage of the envelope
-		const Stage getStage() const { return stage; }
-        
-		// Returns the total length of the envelope (ignoring loops)
-		float getLength() const { return points.size() ? points[points.size() - 1].x : 0.f; }
-        
-		// Trigger the release of the envelope
-		virtual void release(float time, float level = 0.f){
-			stage = Release;
-			setTarget({ time, level }, 0);
+		// latency (host samples; excluding the modifier's own)
+		static float latency() {
+			float samples = 0;
+			for (int s = 0; s < STAGES; s++)
+				samples += float(2 * order(s) - 1) / float(1 << s);
+			return samples;
 		}
 
-		// Returns true if the envelope has finished (is off)
-		bool finished() const {
-			return getStage() == Stage::Off;
+		void reset() {
+			for (HalfBand& stage : stages)
+				stage.reset();
 		}
-        
-		// Prepare envelope to (re)start
-		void initialise(){
-			point = 0;
-			timeInc = 1.0f / fs;
-			loop.reset();
-			stage = Sustain;
-			if(points.size()){
-				out = points[0].y;
-				ramp->setValue(points[0].y);
-				if(points.size() > 1)
-					setTarget(points[1], points[0].x);
-			}else{
-				out = 1.0f;
-				ramp->setValue(1.0f);
+
+		void set(param p) override { Rate rate; modifier(p); }
+		void set(param p1, param p2) override { Rate rate; modifier(p1, p2); }
+		void set(param p1, param p2, param p3) override { Rate rate; modifier(p1, p2, p3); }
+		void set(param p1, param p2, param p3, param p4) override { Rate rate; modifier(p1, p2, p3, p4); }
+
+		void process() override {
+			const signal input = in;
+			signal output;
+			process(&input, &output, 1);
+		}
+
+		void process(const signal* inputs, signal* outputs, int samples) override {
+			for (int offset = 0; offset < samples; offset += BLOCK) {
+				const int n = std::min(BLOCK, samples - offset);
+
+				// upsample (host rate to N x fs)
+				std::copy((const float*)&inputs[offset], (const float*)&inputs[offset] + n, buffers[0].data());
+				for (int s = 0; s < STAGES; s++)
+					stages[s].upsample(buffers[s].data(), buffers[s + 1].data(), n << s);
+
+				// process at N x fs (the modifier may read fs as it runs, e.g. to set() an oscillator per sample)
+				Rate rate;
+				static_cast<Modifier&>(modifier).process((const signal*)buffers[STAGES].data(), (signal*)result.data(), n * N);
+
+				// downsample (back to the host rate)
+				const float* x = result.data();
+				for (int s = STAGES - 1; s >= 0; s--) {
+					float* y = s ? buffers[s].data() : (float*)&outputs[offset];
+					stages[s].downsample(x, y, n << s);
+					x = y;
+				}
 			}
-		}
-        
-		// Scales the envelope duration to specified length 
-		void resize(float length){
-			const float old_length = getLength();
-			if(old_length == 0.0)
-				return;
-            
-			const float multiplier = length / (fs * old_length);
-			std::vector<Point>::iterator point = points.begin();
-			while(point != points.end()){
-				point->x *= multiplier;
-				point++;
+			if (samples) {
+				in = inputs[samples - 1];
+				out = outputs[samples - 1];
 			}
-            
-			initialise();
-		}
-        
-		// Set the current envelope target
-		void setTarget(const Point& point, float time = 0.0){
-			(this->*setTargetFunction)(point, time);
 		}
-        
-		// Returns the output of the envelope and advances the envelope.
-		signal& operator++(int){ 
-			out = (*ramp)++;
-            
-			switch(stage){
-			case Sustain:
-				time += timeInc;
-				if (!ramp->isActive()) { // envelop segment end reached
-					if (loop.isActive() && (point + 1) >= loop.end) {
-						point = loop.start;
-						ramp->setValue(points[point].y);
-						if (loop.start != loop.end)
-							setTarget(points[point + 1], points[point].x);
-					} else if ((point + 1) < points.size()) {
-						if (mode() == Rate || time >= points[point + 1].x) { // reached target point
-							point++;
-							ramp->setValue(points[point].y); // make sure exact value is set
 
-							if ((point + 1) < points.size()) // new target point?
-								setTarget(points[point + 1], points[point].x);
-						}
-					} else {
-						stage = Off;
-					}
-				} break;
-			case Release:
-				if (!ramp->isActive()) //if(out == 0.0)
-					stage = Off;
-				break;
-			case Off:
-				break;
+	protected:
+		std::vector<HalfBand> stages;
+		std::vector<float> buffers[STAGES + 1], result;	// per-rate work buffers (host, 2x, ... N x fs)
+	};
+
+	// streaming sample-rate converter (arbitrary, time-varying ratios)
+	// - ratio: source samples per output sample (e.g. 44100 / 48000 to play a 44.1 kHz asset at 48 kHz)
+	// - Sinc: 32-tap Kaiser-windowed sinc (polyphase table; widened to band-limit when the ratio > 1)
+	// - Cubic: 4-point hermite (cheap; no anti-aliasing)
+	// - streaming: write() source samples, read() output samples (needed() says how many to write)
+	// - as a Modifier: one sample in, one out (e.g. wow/flutter or drift correction; latency() samples)
+	//   input and output share a clock, so a sustained ratio below 1 fills the fifo: past half full, the read
+	//   position is servoed to catch up (bounded latency); a sustained ratio above 1 holds the last output when starved
+	// - ratio changes glide over 64 outputs (the read position is continuous, so no clicks); no allocation after construction
+	class Resampler : public Modifier {
+	public:
+		enum Quality { Cubic, Sinc };
+
+		static constexpr int HALF = 16;				// sinc zero crossings per side
+		static constexpr int TAPS = 2 * HALF;
+		static constexpr int PHASES = 256;			// sinc table resolution (per zero crossing)
+		static constexpr float MIN_RATIO = 1.f / 1024;	// (smallest ratio; set() clamps to [MIN_RATIO, MAX_RATIO])
+		static constexpr float MAX_RATIO = 8.f;		// (largest downsampling ratio)
+
+		const Quality quality;
+
+		Resampler(Quality quality = Sinc, int capacity = 4096)
+		: quality(quality), margin(quality == Sinc ? int(HALF * MAX_RATIO) + 1 : 1),
+		  fifo(capacity + 2 * margin) {
+			if (quality == Sinc) {
+				// one-sided kernel: k(u) = cutoff sinc(cutoff u) window(u / HALF)
+				const double pi = 3.1415926535897932384626433832795, beta = 9.0, cutoff = 0.96;
+				kernel.resize(HALF * PHASES + 2);
+				for (int j = 0; j < (int)kernel.size(); j++) {
+					const double u = double(j) / PHASES, r = u / HALF;
+					const double sinc = u ? sin(pi * cutoff * u) / (pi * u) : cutoff;
+					kernel[j] = r < 1 ? float(sinc * bessel(beta * sqrt(1 - r * r)) / bessel(beta)) : 0.f;
+				}
+
+				// polyphase rows (phase p/PHASES of a sample; tap m at distance p/PHASES + HALF - 1 - m)
+				polyphase.resize((PHASES + 1) * TAPS);
+				for (int p = 0; p <= PHASES; p++)
+					for (int m = 0; m < TAPS; m++)
+						polyphase[p * TAPS + m] = kernel[abs(p + (HALF - 1 - m) * PHASES)];
 			}
-            
-			return out;
+			reset();
 		}
 
-		void process() override { /* do nothing -> only process on ++ */
-			out = *ramp;
-		}
-        
-		// Retrieve a specified envelope point (read-only)
-		const Point& operator[](int point) const {
-			return points[point];
+		void reset() {
+			std::fill(fifo.begin(), fifo.end(), 0.f);
+			count = margin;
+			time = margin;
+			ratio = target = step = 1;
+			glide = 0;
+			dropped = 0;
 		}
 
-		// Set the Ramp class (default: Envelope::Linear)
-		void set(Ramp* ramp) {
-			Envelope::ramp = std::shared_ptr<Ramp>(ramp);
-			initialise();
+		// latency (source samples; when used as a Modifier)
+		int latency() const { return right(); }
+
+		// source samples per output sample (clamped: the history margin only covers the widest kernel at MAX_RATIO)
+		void set(param ratio) override {
+			target = !(ratio.value > MIN_RATIO) ? MIN_RATIO : ratio.value > MAX_RATIO ? MAX_RATIO : ratio.value;
+			glide = 64;
+			step = (target - Resampler::ratio) / glide;
 		}
 
-		void setMode(Mode mode) {
-			if (mode == Time)
-				setTargetFunction = &Envelope::setTargetTime;
-			else
-				setTargetFunction = &Envelope::setTargetRate;
+		int dropped = 0;	// source samples refused by write() since reset() (fifo full)
+
+		// append source samples (returns the number accepted: samples beyond the fifo's room are dropped; see needed())
+		int write(const signal* inputs, int samples) {
+			if (count + samples > (int)fifo.size())
+				compact();
+			const int accepted = std::max(0, std::min(samples, (int)fifo.size() - count));
+			std::copy((const float*)inputs, (const float*)inputs + accepted, &fifo[count]);
+			count += accepted;
+			dropped += samples - accepted;
+			return accepted;
 		}
 
-		Mode mode() const { return setTargetFunction == &Envelope::setTargetTime ? Time : Rate; }
-        
-	protected:
+		int write(signal input) { return write(&input, 1); }
 
-		void (Envelope::* setTargetFunction)(const Point& point, float time) = &Envelope::setTargetTime;
+		// source samples still needed to produce [outputs] more samples (at the current or target ratio)
+		int needed(int outputs) const {
+			const double end = time + (outputs - 1) * (double)std::max(ratio, target);
+			return std::max(0, (int)end + std::max(right(), right(target)) + 1 - count);
+		}
 
-		void setTargetTime(const Point& point, float time = 0.0) {
-			this->time = time;
-			ramp->setTarget(point.y);
-			ramp->setRate(fabsf(point.y - ramp->out) / ((point.x - time) * fs));
+		// produce up to [samples] outputs (returns the number produced)
+		int read(signal* outputs, int samples) {
+			int s = 0;
+			while (s < samples && (int)time + right() < count)
+				outputs[s++] = next();
+			return s;
 		}
 
-		void setTargetRate(const Point& point, float rate = 0.0) {
-			this->time = 0;
-			if (point.x == 0) {
-				ramp->setValue(point.y);
-			} else {
-				ramp->setTarget(point.y);
-				ramp->setRate(point.x);
+		void process() override {
+			servo = true;
+			write(in);
+			if ((int)time + right() < count)
+				out = next();
+		}
+
+		void process(const signal* inputs, signal* outputs, int samples) override {
+			constexpr int chunk = 64; // (small, so the servo sees the fill level of each sample)
+			servo = true;
+			for (int offset = 0; offset < samples; offset += chunk) {
+				const int n = std::min(chunk, samples - offset);
+				write(&inputs[offset], n);
+				const int produced = read(&outputs[offset], n);
+				if (produced < n) {
+					// (starved: hold the last output, keeping the produced samples aligned to the end)
+					std::copy_backward(&outputs[offset], &outputs[offset + produced], &outputs[offset + n]);
+					std::fill(&outputs[offset], &outputs[offset + n - produced], out);
+				}
+				out = outputs[offset + n - 1];
 			}
+			if (samples)
+				in = inputs[samples - 1];
 		}
 
-		std::vector<Point> points;
-		Loop loop;
-        
-		int point;
-		float time, timeInc;
-		Stage stage;
+	protected:
+		// samples needed to the right of the read position
+		int right(float ratio) const { return quality == Cubic ? 2 : ratio > 1 ? (int)ceilf(HALF * ratio) : HALF; }
+		int right() const { return right(ratio); }
+
+		// drop consumed samples (keeping [margin] of history; the read position can be past the last sample when starved)
+		void compact() {
+			const int drop = std::min((int)time, count) - margin;
+			if (drop <= 0)
+				return;
+			std::copy(fifo.begin() + drop, fifo.begin() + count, fifo.begin());
+			count -= drop;
+			time -= drop;
+		}
+
+		// output at the read position, then advance
+		float next() {
+			const int i = (int)time;
+			const float f = float(time - i);
+			const float* x = &fifo[i];
+			float y;
+
+			if (quality == Cubic) {
+				const float c1 = 0.5f * (x[1] - x[-1]);
+				const float c2 = x[-1] - 2.5f * x[0] + 2.f * x[1] - 0.5f * x[2];
+				const float c3 = 0.5f * (x[2] - x[-1]) + 1.5f * (x[0] - x[1]);
+				y = ((c3 * f + c2) * f + c1) * f + x[0];
+			} else if (ratio <= 1) {
+				// interpolate between adjacent polyphase rows, then a SIMD dot product
+				const float p = f * PHASES;
+				const int j = (int)p;
+				const float a = p - (float)j;
+				const float* row0 = &polyphase[j * TAPS];
+				const float* row1 = row0 + TAPS;
+				alignas(32) float weights[TAPS];
+				for (int m = 0; m < TAPS; m++)
+					weights[m] = row0[m] + (row1[m] - row0[m]) * a;
+				y = dot(weights, x - HALF + 1, TAPS);
+			} else {
+				// widened kernel (cutoff scaled by 1 / ratio)
+				const float scale = 1.f / ratio;
+				const int S = right();
+				y = 0;
+				for (int n = 1 - S; n <= S; n++) {
+					const float d = fabsf(float(n) - f) * scale * PHASES;
+					const int k = (int)d;
+					if (k < HALF * PHASES)
+						y += x[n] * (kernel[k] + (kernel[k + 1] - kernel[k]) * (d - (float)k));
+				}
+				y *= scale;
+			}
 
-		std::shared_ptr<Ramp> ramp;
+			time += ratio;
+			if (servo) { // (Modifier: past half full, read faster to catch up with the input)
+				const double excess = (count - time) - 0.5 * (double)fifo.size();
+				if (excess > 0)
+					time += excess * (1.0 / 256);
+			}
+			if (glide && !--glide)
+				ratio = target;
+			else if (glide)
+				ratio += step;
+			return y;
+		}
+
+		const int margin;					// history kept left of the read position
+		std::vector<float> fifo, kernel, polyphase;
+		int count;							// samples in the fifo
+		double time;						// read position (fifo index)
+		float ratio, target, step;
+		int glide;
+		bool servo = false;					// (set when used as a Modifier)
 	};
 
-	struct ADSR : public Envelope {
-		param A, D, S, R;
+	// white noise
+	class Noise : public Generator {
+	public:
+		Random random;
 
-		enum Mode { Time, Rate } mode = Time;
+		void seed(unsigned long long seed) { random.seed(seed); }
 
-		ADSR() { set(0.5, 0.5, 1, 0.5); }
+		void process() {
+			out = random.bipolar();
+		}
 
-		void set(param attack, param decay, param sustain, param release) override {
-			A = attack + 0.005f;
-			D = decay + 0.005f;
-			S = sustain;
-			R = release + 0.005f;
+		void process(signal* outputs, int samples) override {
+			random.fill((float*)outputs, samples);
+			if (samples)
+				out = outputs[samples - 1];
+		}
+	};
 
-			points.resize(3);
-			points[0] = { 0, 0 };
-			points[1] = { A, 1 };
-			points[2] = { A + D, S };
-			
-			initialise();
-			setLoop(2, 2);
+	// pink noise (-3dB/octave; Paul Kellet's refined filter)
+	class PinkNoise : public Noise {
+		float b0 = 0, b1 = 0, b2 = 0, b3 = 0, b4 = 0, b5 = 0, b6 = 0;
+
+		float filter(float white) {
+			b0 = 0.99886f * b0 + white * 0.0555179f;
+			b1 = 0.99332f * b1 + white * 0.0750759f;
+			b2 = 0.96900f * b2 + white * 0.1538520f;
+			b3 = 0.86650f * b3 + white * 0.3104856f;
+			b4 = 0.55000f * b4 + white * 0.5329522f;
+			b5 = -0.7616f * b5 - white * 0.0168980f;
+			const float pink = b0 + b1 + b2 + b3 + b4 + b5 + b6 + white * 0.5362f;
+			b6 = white * 0.115926f;
+			return pink * 0.11f; // (~unity gain)
 		}
 
-		void release(float time = 0.f, float level = 0.f) override {
-			Envelope::release(time ? time : float(R), level);
+	public:
+		void process() {
+			out = filter(random.bipolar());
 		}
 
-		bool operator==(Envelope::Stage stage) const {
-			return getStage() == stage;
+		void process(signal* outputs, int samples) override {
+			random.fill((float*)outputs, samples);
+			for (int s = 0; s < samples; s++)
+				outputs[s] = filter(outputs[s]);
+			if (samples)
+				out = outputs[samples - 1];
 		}
 	};
 
-	template<class OSCILLATOR>
-	struct Operator : public OSCILLATOR, public Input {
-		Envelope env;
-		Amplitude amp = 1.f;
+	// brown(ian) noise (-6dB/octave; leaky integrator)
+	class BrownNoise : public Noise {
+		float y = 0;
 
-		Operator& operator()(param f) { OSCILLATOR::set(f); return *this; }
-		Operator& operator()(param f, relative phase) { OSCILLATOR::set(f, phase); return *this; }
-		Operator& operator()(relative phase) { OSCILLATOR::set(phase); return *this; }
+	public:
+		void process() {
+			out = (y = (y + 0.02f * random.bipolar()) * (1.f / 1.02f)) * 3.5f;
+		}
 
-		virtual Operator& operator=(const Envelope::Points& points) {
-			env = points;
-			return *this;
+		void process(signal* outputs, int samples) override {
+			random.fill((float*)outputs, samples);
+			for (int s = 0; s < samples; s++)
+				outputs[s] = (y = (y + 0.02f * outputs[s]) * (1.f / 1.02f)) * 3.5f;
+			if (samples)
+				out = outputs[samples - 1];
 		}
+	};
 
-		virtual Operator& operator=(const Envelope& points) {
-			env = points;
-			return *this;
+	class Wavetable : public Oscillator {
+		using Oscillator::set;
+	public:
+		// immutable set of band-limited tables (one mip level per octave of increment)
+		struct Table {
+			enum Shape { Custom, Sine, Saw, Square, Triangle };
+
+			// guard points around each level (so interpolation never needs to wrap)
+			static constexpr int BEFORE = 1, AFTER = 2;
+
+			const int size;		// samples per level
+			const int levels;	// level n holds harmonics up to (size / 2) >> n
+			const int stride;	// size + guard points
+			std::vector<float> samples;
+
+			Table(int size, int levels = 1) : size(size), levels(levels), stride(BEFORE + size + AFTER), samples(stride * levels, 0.f) { }
+
+			const float* level(int index) const { return &samples[index * stride + BEFORE]; }
+			float* level(int index) { return &samples[index * stride + BEFORE]; }
+
+			// refreshes the guard points (after writing to a level)
+			void wrap() {
+				for (int l = 0; l < levels; l++) {
+					float* samples = level(l);
+					for (int g = 1; g <= BEFORE; g++)
+						samples[-g] = samples[size - g];
+					for (int g = 0; g < AFTER; g++)
+						samples[size + g] = samples[g % size];
+				}
+			}
+
+			// returns the richest level whose harmonics stay below nyquist at the given increment (samples per sample)
+			int select(float increment) const {
+				int level = 0;
+				while (level < levels - 1 && float(1 << level) < increment)
+					level++;
+				return level;
+			}
+
+			// returns a shared table (built additively on first use, released when no longer referenced)
+			// - tables are rate-independent (mip levels are selected by increment), so shared across rates
+			static std::shared_ptr<const Table> get(Shape shape, int size = 2048) {
+				static std::mutex mutex;
+				static std::map<std::pair<int, int>, std::weak_ptr<const Table>> cache;
+
+				std::lock_guard<std::mutex> lock(mutex);
+				std::weak_ptr<const Table>& entry = cache[{ shape, size }];
+				std::shared_ptr<const Table> table = entry.lock();
+				if (!table)
+					entry = table = build(shape, size);
+				return table;
+			}
+
+		protected:
+			// amplitude of harmonic n (n >= 1) for a given shape
+			static double harmonic(Shape shape, int n) {
+				constexpr double PI = 3.1415926535897932384626433832795;
+				switch (shape) {
+				case Sine:		return n == 1 ? 1.0 : 0.0;
+				case Saw:		return -2.0 / (PI * n);	// rising ramp (matching Basic::Saw)
+				case Square:	return (n & 1) ? 4.0 / (PI * n) : 0.0;
+				case Triangle:	return (n & 1) ? ((n & 2) ? -8.0 : 8.0) / (PI * PI * n * n) : 0.0;
+				default:		return 0.0;
+				}
+			}
+
+			static std::shared_ptr<const Table> build(Shape shape, int size) {
+				int levels = 1;
+				if (shape != Sine)
+					while (((size / 2) >> levels) > 0)
+						levels++;
+
+				std::vector<double> sine(size);
+				for (int s = 0; s < size; s++)
+					sine[s] = sin(2.0 * 3.1415926535897932384626433832795 * s / size);
+
+				std::shared_ptr<Table> table = std::make_shared<Table>(size, levels);
+				std::vector<double> sum(size);
+				for (int level = 0; level < levels; level++) {
+					const int harmonics = std::max(1, (size / 2) >> level);
+					std::fill(sum.begin(), sum.end(), 0.0);
+					for (int n = 1; n <= harmonics; n++) {
+						const double amplitude = harmonic(shape, n);
+						if (amplitude == 0.0)
+							continue;
+						for (int s = 0, i = 0; s < size; s++, i = (i + n) % size)
+							sum[s] += amplitude * sine[i];
+					}
+					float* samples = table->level(level);
+					for (int s = 0; s < size; s++)
+						samples[s] = (float)sum[s];
+				}
+				table->wrap();
+				return table;
+			}
+		};
+
+		enum Interpolation { Truncate, Linear, Cubic };
+
+		Interpolation interpolation = Linear;
+
+	protected:
+		std::shared_ptr<const Table> table;
+		std::shared_ptr<Table> custom;	// private (writable) table
+		const float* mip;				// current mip level
+		const int size;
+		const int bits;					// log2(size), or 0 if size is not a power of two
+
+		// fixed-point phase (full range = one cycle; integer math, wraps for free)
+		accumulator phase, delta;
+		unsigned int phaseOffset = 0;
+
+		Table& edit() {
+			if (!custom) {
+				custom = std::make_shared<Table>(size);
+				std::copy(mip, mip + size, custom->level(0));
+				custom->wrap();
+				table = custom;
+				mip = table->level(0);
+			}
+			return *custom;
 		}
 
-		Operator& operator*(float amp) {
-			Operator::amp = amp;
-			return *this;
+		static unsigned int fixed(float cycles) {
+			return (unsigned int)(long long)(double(cycles) * 4294967296.0);
 		}
 
-		virtual void process() override {
-			OSCILLATOR::set(+in);
-			OSCILLATOR::process();
-			OSCILLATOR::out *= env++ * amp;
+		// convert uint32 to float [0, 1)
+		static float fraction(unsigned int phase) {
+			return bit_cast<float>((phase >> 9) | 0x3f800000) - 1.f;
 		}
-	};
 
-	template<class OSCILLATOR>
-	inline signal operator>>(klang::signal modulator, Operator<OSCILLATOR>& carrier) {
-		carrier << modulator;
-		return carrier;
-	}
+		template<Interpolation MODE>
+		static float read(const float* mip, int size, unsigned int phase) {
+			const unsigned long long p = (unsigned long long)phase * (unsigned int)size;
+			const float* y = &mip[p >> 32];
+			if constexpr (MODE == Truncate) {
+				return y[0];
+			} else {
+				const float f = fraction((unsigned int)p);
+				if constexpr (MODE == Linear) {
+					return y[0] + (y[1] - y[0]) * f;
+				} else { // cubic hermite (catmull-rom)
+					const float c1 = 0.5f * (y[1] - y[-1]);
+					const float c2 = y[-1] - 2.5f * y[0] + 2.f * y[1] - 0.5f * y[2];
+					const float c3 = 0.5f * (y[2] - y[-1]) + 1.5f * (y[0] - y[1]);
+					return ((c3 * f + c2) * f + c1) * f + y[0];
+				}
+			}
+		}
 
-	inline param* param::convert(Type to) {
-		switch (type() > to) {
-			case Type::Frequency > Type::Pitch:
-				return new Pitch(log2(value / 440) * 12 + 69);
+		template<Interpolation MODE>
+		void render(float* outputs, int samples) {
+			if constexpr (accumulator::BITS > 32) { // (wider phases step in full precision, as per sample)
+				accumulator p = Wavetable::phase;
+				for (int s = 0; s < samples; s++) {
+					p += Wavetable::delta;
+					outputs[s] = read<MODE>(mip, size, p.top() + phaseOffset);
+				}
+				Wavetable::phase = p;
+				return;
+			}
 
-				case Type::Pitch > Type::Frequency:
-					return new Frequency(440 * pow(2, (value - 69) / 12));
+			int s = 0;
+			unsigned int phase = Wavetable::phase.top() + phaseOffset;
+			const unsigned int delta = Wavetable::delta.top();
+#if defined(KLANG_AVX2)
+			if (bits) { // power-of-two table: index/fraction by shifts, 8 reads per gather
+				const __m128i index = _mm_cvtsi32_si128(32 - bits), frac = _mm_cvtsi32_si128(bits);
+				const __m256i step = _mm256_set1_epi32(int(delta * 8u));
+				__m256i p = _mm256_add_epi32(_mm256_set1_epi32(int(phase + delta)), _mm256_mullo_epi32(_mm256_set1_epi32(int(delta)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+				for (; s + 8 <= samples; s += 8) {
+					const __m256i i = _mm256_srl_epi32(p, index);
+					const __m256 y0 = _mm256_i32gather_ps(mip, i, 4);
+					if constexpr (MODE == Truncate) {
+						_mm256_storeu_ps(&outputs[s], y0);
+					} else {
+						const __m256 one = _mm256_set1_ps(1.f);
+						const __m256 f = _mm256_sub_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_srli_epi32(_mm256_sll_epi32(p, frac), 9), _mm256_castps_si256(one))), one);
+						const __m256 y1 = _mm256_i32gather_ps(mip + 1, i, 4);
+						if constexpr (MODE == Linear) {
+							_mm256_storeu_ps(&outputs[s], _mm256_add_ps(y0, _mm256_mul_ps(_mm256_sub_ps(y1, y0), f)));
+						} else {
+							const __m256 ym = _mm256_i32gather_ps(mip - 1, i, 4);
+							const __m256 y2 = _mm256_i32gather_ps(mip + 2, i, 4);
+							const __m256 half = _mm256_set1_ps(0.5f);
+							const __m256 c1 = _mm256_mul_ps(half, _mm256_sub_ps(y1, ym));
+							const __m256 c2 = _mm256_sub_ps(_mm256_add_ps(_mm256_sub_ps(ym, _mm256_mul_ps(_mm256_set1_ps(2.5f), y0)), _mm256_add_ps(y1, y1)), _mm256_mul_ps(half, y2));
+							const __m256 c3 = _mm256_add_ps(_mm256_mul_ps(half, _mm256_sub_ps(y2, ym)), _mm256_mul_ps(_mm256_set1_ps(1.5f), _mm256_sub_ps(y0, y1)));
+							__m256 y = _mm256_add_ps(_mm256_mul_ps(c3, f), c2);
+							y = _mm256_add_ps(_mm256_mul_ps(y, f), c1);
+							_mm256_storeu_ps(&outputs[s], _mm256_add_ps(_mm256_mul_ps(y, f), y0));
+						}
+					}
+					p = _mm256_add_epi32(p, step);
+				}
+				phase += delta * (unsigned int)s;
+			}
+#endif
+			for (; s < samples; s++) {
+				phase += delta;
+				outputs[s] = read<MODE>(mip, size, phase);
+			}
+			Wavetable::phase += Wavetable::delta * (unsigned int)samples;
+		}
 
-				default:
-					return nullptr;
+		static int log2(int size) {
+			int bits = 0;
+			while ((1 << bits) < size)
+				bits++;
+			return (1 << bits) == size ? bits : 0;
 		}
-	}
 
-	inline void param::convert(const param& from, param& to) {
-		switch (from.type() > to.type())
-		{
-			case Type::Frequency > Type::Pitch:
-				to.value = log2f(from.value / 440) * 12 + 69;
-				break;
-				case Type::Pitch > Type::Frequency:
-					to.value = (float)(440 * pow(2, (from.value - 69) / 12));
-					break;
+	public:
+		Wavetable(int size = 2048) : custom(std::make_shared<Table>(size)), size(size), bits(log2(size)) { 
+			table = custom;
+			mip = table->level(0);
 		}
-	}
 
-	struct Plugin {
-		virtual ~Plugin() { }
+		Wavetable(Table::Shape shape, int size = 2048) : table(Table::get(shape, size)), size(size), bits(log2(size)) { 
+			mip = table->level(0);
+		}
 
-		virtual void onParameter(int index, float value) { };
-		virtual void onPreset(int index) { };
+		template<typename TYPE>
+		Wavetable(TYPE oscillator, int size = 2048) : Wavetable(size) {
+			operator=(oscillator);
+		}
+		
+		signal& operator[](int index) {
+			return *(signal*)&edit().level(0)[index]; // (guard points refreshed on set())
+		}
 
-		Controls controls;
-		Presets presets;
-	};
+		signal operator[](int index) const {
+			return table->level(0)[index];
+		}
 
-	struct Effect : public Plugin, public Modifier {
-		virtual ~Effect() { }
+		template<typename TYPE>
+		Wavetable& operator=(TYPE& oscillator) {
+			signal* samples = (signal*)edit().level(0);
+			oscillator.set(fs / size);
+			for (int s = 0; s < size; s++)
+				samples[s] = oscillator;
+			custom->wrap();
+			return *this;
+		}
 
-		virtual void prepare() { };
-		virtual void process() { out = in; }
-		virtual void process(buffer buffer) {
-			prepare();
-			while (buffer) {
-				input(buffer);
-				process();
-				buffer++ = out;
-				debug++;
+		virtual void reset() override {
+			Oscillator::reset();
+			phase = accumulator();
+		}
+
+		virtual void set(param frequency) override {
+			Oscillator::frequency = frequency;
+			increment = frequency * (size / fs);
+			delta = accumulator::frequency(frequency);
+			if (custom)
+				custom->wrap();
+			mip = table->level(table->select(increment));
+		}
+
+		virtual void set(param frequency, param phase) override {
+			position = phase * float(size);
+			Wavetable::phase = accumulator::cycles(phase);
+			set(frequency);
+		}
+
+		virtual void set(relative phase) override {
+			offset = phase * float(size);
+			phaseOffset = fixed(phase);
+		}
+
+		virtual void set(param frequency, relative phase) override {
+			set(frequency);
+			set(phase);
+		}
+
+		void process() override {
+			phase += delta;
+			const unsigned int p = phase.top() + phaseOffset;
+			switch (interpolation) {
+			case Truncate:	out = read<Truncate>(mip, size, p); break;
+			case Linear:	out = read<Linear>(mip, size, p); break;
+			case Cubic:		out = read<Cubic>(mip, size, p); break;
 			}
 		}
+
+		void process(signal* outputs, int samples) override {
+			switch (interpolation) {
+			case Truncate:	render<Truncate>((float*)outputs, samples); break;
+			case Linear:	render<Linear>((float*)outputs, samples); break;
+			case Cubic:		render<Cubic>((float*)outputs, samples); break;
+			}
+			if (samples)
+				out = outputs[samples - 1];
+		}
 	};
 
-	template<class SYNTH>
-	class NoteBase {
-		SYNTH* synth;
+	// Models a changing value (e.g. amplitude) over time (in seconds) using breakpoints (time, value)
+	class Envelope : public Generator {
+		using Generator::set;
 
-		class Controls {
-			klang::Controls* controls = nullptr;
+	public:
+		// Abstract envelope ramp type (override to support different point-to-point trajectories)
+		struct Ramp : public Generator {
+			float target;
+			float rate;
+			bool active = false;
 		public:
-			Controls& operator=(klang::Controls& controls) { Controls::controls = &controls; return *this; }
-			float& operator[](int index) { return controls->operator[](index); }
-			unsigned int size() { return controls ? controls->size() : 0; }
+
+			// Create a null ramp (full signal)
+			Ramp(float value = 1.f) {
+				setValue(value);
+			}
+
+			// Create a ramp from start to target over time (in seconds)
+			Ramp(float start, float target, float time) {
+				setValue(start);
+				setTarget(target);
+				setTime(time);
+			}
+
+			virtual ~Ramp() { }
+
+			// Is ramp currently processing (ramping)?
+			bool isActive() const {
+				return active;
+			}
+
+			// Set a new target (retains rate)
+			virtual void setTarget(float target) {
+				Ramp::target = target;
+				active = (out != target);
+			}
+
+			// Immediately jump to value (disables ramp)
+			virtual void setValue(float value) {
+				out = value;
+				Ramp::target = value;
+				active = false;
+			}
+
+			// Set rate of change (per sample)
+			virtual void setRate(float rate) { Ramp::rate = rate; }
+
+			// Set rate of change (by duration)
+			virtual void setTime(float time) { Ramp::rate = time ? 1.f / (time * fs) : 0; }
+
+			// Return the current output and advanced the ramp
+			virtual signal operator++(int) = 0;
+
+			void process() override { /* do nothing -> only process on ++ */ }
 		};
 
-	protected:
-		virtual event on(Pitch p, Velocity v) { }
-		virtual event off(Velocity v = 0) { stage = Off; }
-		virtual event control(int controller, int value) { };
+		// Default (linear) ramp implementation
+		struct Linear : public Ramp {
 
-		SYNTH* getSynth() { return synth; }
-	public:
-		Pitch pitch;
-		Velocity velocity;
-		Controls controls;
+			// Return the current output and process the next
+			signal operator++(int) override {
+				const signal output = out;
 
-		NoteBase() : synth(nullptr) { }
-		virtual ~NoteBase() { }
+				if (active) {
+					if (target > out) {
+						out += rate;
+						if (out >= target) {
+							out = target;
+							active = false;
+						}
+					}
+					else {
+						out -= rate;
+						if (out <= target) {
+							out = target;
+							active = false;
+						}
+					}
+				}
+
+				return output;
+			}
+		};
+
+		enum Stage { Sustain, Release, Off };
+		enum Mode { Time, Rate };
+
+		// Envelope point type
+		struct Point {
+			float x, y;
+
+			Point() : x(0), y(0) { }
+			
+			template<typename T1, typename T2>
+			Point(T1 x, T2 y) : x(float(x)), y(float(y)) { }
+		};
+
+		// Linked-list of points (for inline initialisation)
+		struct Points : public Point {
+			Points(float x, float y) {
+				Point::x = x;
+				Point::y = y;
+				next = NULL;
+			}
+			~Points() {
+				delete next;
+			}
+
+			Points& operator()(float x, float y) {
+				last().next = new Points(x, y);
+				return *this;
+			}
+
+			Points& last() {
+				return next ? next->last() : *this;
+			}
+
+			int count() const {
+				return next ? 1 + next->count() : 1;
+			}
+
+			Points* next;
+		};
+
+		// Envelope loop (between two points)
+		struct Loop {
+			Loop(int from = -1, int to = -1) : start(from), end(to) {}
+
+			void set(int from, int to) { start = from; end = to; }
+			void reset() { start = end = -1; }
+
+			bool isActive() const { return start != -1 && end != -1; }
+
+			int start;
+			int end;
+		};
+
+		// Default Envelope (full signal)
+		Envelope() : ramp(new Linear()) {										set(Points(0.f, 1.f));	}
+
+		// Creates a new envelope from a list of points, e.g. Envelope env = Envelope::Points(0,1)(1,0);
+		Envelope(const Points& points) : ramp(new Linear()) {					set(points);			}
+
+		// Creates a new envelope from a list of points, e.g. Envelope env = { { 0,1 }, { 1,0 } };
+		Envelope(std::initializer_list<Point> points) : ramp(new Linear()) {	set(points);			}
+
+		// Creates a copy of an envelope from another envelope
+		Envelope(const Envelope& in) : ramp(new Linear()) {						set(in.points);			}
+
+		virtual ~Envelope() { }
+
+		// Checks if the envelope is at a specified stage (Sustain, Release, Off)
+		bool operator==(Stage stage) const { return Envelope::stage == stage; }
+		bool operator!=(Stage stage) const { return Envelope::stage != stage; }
+
+		operator float() const { return out; }
+
+		// assign points (without recreating envelope)
+		Envelope& operator=(std::initializer_list<Point> points) {
+			set(points);
+			return *this;
+		}
+
+		// Sets the envelope based on an array of points
+		void set(const std::vector<Point>& points) {
+			Envelope::points = points;
+			initialise();
+		}
+
+		// Sets the envelope from a list of points, e.g. env.set( Envelope::Points(0,1)(1,0) );
+		void set(const Points& point){
+			points.clear();
+            
+			const Points* pPoint = &point;
+			while(pPoint){
+				points.push_back(*pPoint);
+				pPoint = pPoint->next;
+			}
+            
+			initialise();
+		}
+
+		// Converts envelope points based on relative time to absolute time
+		void sequence() {
+			float time = 0.f;
+			for(Point& point : points) {
+				const float delta = point.x;
+				time += delta + 0.00001f;
+				point.x = time;
+			}
+			initialise();
+		}
+
+		// Sets an envelope loop between two points
+		void setLoop(int startPoint, int endPoint){
+			if(startPoint >= 0 && endPoint < points.size())
+				loop.set(startPoint, endPoint);
+		}
+
+		// Retrieve value at time (in seconds)
+		signal at(param time) {
+			if (points.empty()) return 0;
+			Point last = { 0, points[0].y };
+			for (const Point& point : points) {
+				if (point.x >= time) {
+					const float dx = point.x - last.x;
+					const float dy = point.y - last.y;
+					const float x = time - last.x;
+					return dx == 0 ? last.y : (last.y + x * dy / dx);
+				}
+				last = point;
+			}
+			return points.back().y;
+		}
+
+		//void set(param time) override {
+		//	setTargetValue(at(time), 1.f);
+		//}
+        
+		// Resets the envelope loop
+		void resetLoop(){
+			loop.reset();
+			if(stage == Sustain && (point+1) < points.size())
+				setTarget(points[point+1], points[point].x);
+		}
+        
+		// Sets the current stage of the envelope
+		void setStage(Stage stage){ this->stage = stage; }
+
+		// Returns the current stage of the envelope
+		const Stage getStage() const { return stage; }
+        
+		// Returns the total length of the envelope (ignoring loops)
+		float getLength() const { return points.size() ? points[points.size() - 1].x : 0.f; }
+        
+		// Trigger the release of the envelope
+		virtual void release(float time, float level = 0.f){
+			stage = Release;
+			setTarget({ time, level }, 0);
+		}
+
+		// Returns true if the envelope has finished (is off)
+		bool finished() const {
+			return getStage() == Stage::Off;
+		}
+        
+		// Prepare envelope to (re)start
+		void initialise(){
+			point = 0;
+			timeInc = 1.0f / fs;
+			loop.reset();
+			stage = Sustain;
+			if(points.size()){
+				out = points[0].y;
+				ramp->setValue(points[0].y);
+				if(points.size() > 1)
+					setTarget(points[1], points[0].x);
+			}else{
+				out = 1.0f;
+				ramp->setValue(1.0f);
+			}
+		}
+        
+		// Scales the envelope duration to specified length 
+		void resize(float length){
+			const float old_length = getLength();
+			if(old_length == 0.0)
+				return;
+            
+			const float multiplier = length / (fs * old_length);
+			std::vector<Point>::iterator point = points.begin();
+			while(point != points.end()){
+				point->x *= multiplier;
+				point++;
+			}
+            
+			initialise();
+		}
+        
+		// Set the current envelope target
+		void setTarget(const Point& point, float time = 0.0){
+			(this->*setTargetFunction)(point, time);
+		}
+        
+		// Returns the output of the envelope and advances the envelope.
+		signal& operator++(int){ 
+			out = (*ramp)++;
+            
+			switch(stage){
+			case Sustain:
+				time += timeInc;
+				if (!ramp->isActive()) { // envelop segment end reached
+					if (loop.isActive() && (point + 1) >= loop.end) {
+						point = loop.start;
+						ramp->setValue(points[point].y);
+						if (loop.start != loop.end)
+							setTarget(points[point + 1], points[point].x);
+					} else if ((point + 1) < points.size()) {
+						if (mode() == Rate || time >= points[point + 1].x) { // reached target point
+							point++;
+							ramp->setValue(points[point].y); // make sure exact value is set
+
+							if ((point + 1) < points.size()) // new target point?
+								setTarget(points[point + 1], points[point].x);
+						}
+					} else {
+						stage = Off;
+					}
+				} break;
+			case Release:
+				if (!ramp->isActive()) //if(out == 0.0)
+					stage = Off;
+				break;
+			case Off:
+				break;
+			}
+            
+			return out;
+		}
+
+		void process() override { /* do nothing -> only process on ++ */
+			out = *ramp;
+		}
+
+		// Renders the envelope into a block (advancing the envelope, as per ++)
+		void process(signal* outputs, int samples) override {
+			for (int s = 0; s < samples; s++)
+				outputs[s] = operator++(0);
+		}
+        
+		// Retrieve a specified envelope point (read-only)
+		const Point& operator[](int point) const {
+			return points[point];
+		}
+
+		// Set the Ramp class (default: Envelope::Linear)
+		void set(Ramp* ramp) {
+			Envelope::ramp = std::shared_ptr<Ramp>(ramp);
+			initialise();
+		}
+
+		void setMode(Mode mode) {
+			if (mode == Time)
+				setTargetFunction = &Envelope::setTargetTime;
+			else
+				setTargetFunction = &Envelope::setTargetRate;
+		}
+
+		Mode mode() const { return setTargetFunction == &Envelope::setTargetTime ? Time : Rate; }
+        
+	protected:
+
+		void (Envelope::* setTargetFunction)(const Point& point, float time) = &Envelope::setTargetTime;
+
+		void setTargetTime(const Point& point, float time = 0.0) {
+			this->time = time;
+			ramp->setTarget(point.y);
+			ramp->setRate(fabsf(point.y - ramp->out) / ((point.x - time) * fs));
+		}
+
+		void setTargetRate(const Point& point, float rate = 0.0) {
+			this->time = 0;
+			if (point.x == 0) {
+				ramp->setValue(point.y);
+			} else {
+				ramp->setTarget(point.y);
+				ramp->setRate(point.x);
+			}
+		}
+
+		std::vector<Point> points;
+		Loop loop;
+        
+		int point;
+		float time, timeInc;
+		Stage stage;
+
+		std::shared_ptr<Ramp> ramp;
+	};
+
+	struct ADSR : public Envelope {
+		param A, D, S, R;
+
+		enum Mode { Time, Rate } mode = Time;
+
+		ADSR() { set(0.5, 0.5, 1, 0.5); }
+
+		void set(param attack, param decay, param sustain, param release) override {
+			A = attack + 0.005f;
+			D = decay + 0.005f;
+			S = sustain;
+			R = release + 0.005f;
+
+			points.resize(3);
+			points[0] = { 0, 0 };
+			points[1] = { A, 1 };
+			points[2] = { A + D, S };
+			
+			initialise();
+			setLoop(2, 2);
+		}
+
+		void release(float time = 0.f, float level = 0.f) override {
+			Envelope::release(time ? time : float(R), level);
+		}
+
+		bool operator==(Envelope::Stage stage) const {
+			return getStage() == stage;
+		}
+	};
+
+	template<class OSCILLATOR>
+	struct Operator : public OSCILLATOR, public Input {
+		Envelope env;
+		Amplitude amp = 1.f;
+
+		Operator& operator()(param f) { OSCILLATOR::set(f); return *this; }
+		Operator& operator()(param f, relative phase) { OSCILLATOR::set(f, phase); return *this; }
+		Operator& operator()(relative phase) { OSCILLATOR::set(phase); return *this; }
+
+		virtual Operator& operator=(const Envelope::Points& points) {
+			env = points;
+			return *this;
+		}
+
+		virtual Operator& operator=(const Envelope& points) {
+			env = points;
+			return *this;
+		}
+
+		Operator& operator*(float amp) {
+			Operator::amp = amp;
+			return *this;
+		}
+
+		virtual void process() override {
+			OSCILLATOR::set(+in);
+			OSCILLATOR::process();
+			OSCILLATOR::out *= env++ * amp;
+		}
+	};
+
+	template<class OSCILLATOR>
+	inline signal operator>>(klang::signal modulator, Operator<OSCILLATOR>& carrier) {
+		carrier << modulator;
+		return carrier;
+	}
+
+	inline float param::convert(float value, Conversion direction) {
+		switch (direction) {
+			case Type::Frequency > Type::Pitch:		return conversion::frequency2pitch(value);
+			case Type::Pitch > Type::Frequency:		return conversion::pitch2frequency(value);
+			case Type::Gain > Type::Amplitude:		return conversion::dB2amplitude(value);
+			case Type::Amplitude > Type::Gain:		return conversion::amplitude2dB(value);
+			default:								return value;
+		}
+	}
+
+	inline param param::convert(Type to) const {
+		return convert(value, type() > to);
+	}
+
+	inline void param::convert(const param& from, param& to) {
+		to.value = convert(from.value, from.type() > to.type());
+	}
+
+	struct Plugin {
+		// creates a plugin whose members are allocated from its own pool (e.g. by the host)
+		// - the caller's pool is restored once the plugin is constructed
+		template<class PLUGIN, typename... ARGS>
+		static PLUGIN* create(ARGS&&... args) {
+			Pool::Scope scope;
+			creating() = true;
+			return new PLUGIN(std::forward<ARGS>(args)...);
+		}
+
+		Plugin() {
+			if (creating()) {
+				creating() = false;
+				Pool::use(&pool);
+			}
+		}
+		virtual ~Plugin() { }
+
+		virtual void onParameter(int index, float value) { };
+		virtual void onPreset(int index) { };
+
+		Controls controls;
+		Presets presets;
+		Pool pool;
+
+	private:
+		static bool& creating() { thread_local static bool flag = false; return flag; }
+	};
+
+	struct Effect : public Plugin, public Modifier {
+		virtual ~Effect() { }
+
+		virtual void prepare() { };
+		virtual void process() { out = in; }
+		virtual void process(buffer buffer) {
+			prepare();
+			process(&(signal&)buffer, &(signal&)buffer, buffer.remaining());
+		}
+		virtual void process(const signal* inputs, signal* outputs, int samples) override {
+			for (int s = 0; s < samples; s++) {
+				input(inputs[s]);
+				process();
+				outputs[s] = out;
+				debug++;
+			}
+		}
+	};
+
+	template<class SYNTH>
+	class NoteBase {
+		SYNTH* synth;
+
+		class Controls {
+			klang::Controls* controls = nullptr;
+		public:
+			Controls& operator=(klang::Controls& controls) { Controls::controls = &controls; return *this; }
+			float& operator[](int index) { return controls->operator[](index); }
+			unsigned int size() { return controls ? controls->size() : 0; }
+		};
+
+	protected:
+		virtual event on(Pitch p, Velocity v) { }
+		virtual event off(Velocity v = 0) { stage = Off; }
+		virtual event control(int controller, int value) { };
+
+		SYNTH* getSynth() { return synth; }
+	public:
+		Pitch pitch;
+		Velocity velocity;
+		Controls controls;
+
+		NoteBase() : synth(nullptr) { }
+		virtual ~NoteBase() { }
+
+		void attach(SYNTH* synth) {
+			NoteBase::synth = synth;
+			controls = synth->controls;
+			init();
+		}
+
+		virtual void init() { }
+
+		virtual void start(Pitch p, Velocity v) {
+			stage = Onset;
+			pitch = p;
+			velocity = v;
+			on(pitch, velocity);
+			stage = Sustain;
+		}
+
+		virtual bool release(Velocity v = 0) {
+			if (stage == Off)
+				return true;
+
+			if (stage != Release) {
+				stage = Release;
+				off(v);
+			}
+			
+			return stage == Off;
+		}
+
+		virtual bool stop(Velocity v = 0) {
+			stage = Off;
+			return true;
+		}
+
+		bool finished() const { return stage == Off; }
+
+		enum Stage { Onset, Sustain, Release, Off } stage = Off;
+
+		virtual void controlChange(int controller, int value) { control(controller, value); };
+	};
+
+	struct Synth;
+
+	// base class for individual synthesiser notes/voices
+	struct Note : public NoteBase<Synth>, public Generator {
+		virtual void prepare() { }
+		virtual void process() override = 0;
+		virtual bool process(buffer buffer) {
+			prepare();
+			process(&(signal&)buffer, buffer.remaining());
+			return !finished();
+		}
+		virtual void process(signal* outputs, int samples) override {
+			for (int s = 0; s < samples; s++) {
+				process();
+				outputs[s] = out;
+				debug++;
+			}
+		}
+		virtual bool process(buffer* buffer) {
+			return process(buffer[0]);
+		}
+	};
+
+	template<class SYNTH, class NOTE = Note>
+	struct Notes : Array<NOTE*, 128> {
+		SYNTH* synth;
+		typedef Array<NOTE*, 128> Array;
+		using Array::items;
+		using Array::count;
+
+		Notes(SYNTH* synth) : synth(synth) {
+			for (int n = 0; n < 128; n++)
+				items[n] = nullptr;
+		}
+		virtual ~Notes();
+
+		template<class TYPE>
+		void add(int count) {
+			Pool::Scope scope(&synth->pool);	// (voices share the synth's pool)
+			for (int n = 0; n < count; n++) {
+				TYPE* note = new TYPE();
+				note->attach(synth);
+				Array::add(note);
+			}
+		}
+
+		// returns index of a 'free' note (stealing oldest, if required)
+		unsigned int noteOns = 0;				// number of NoteOn events processed
+		unsigned int noteStart[128] = { 0 };	// track age of notes (for note stealing)
+
+		int assign(){
+			// favour unused voices
+			for (int i = 0; i < count; i++) {
+				if (items[i]->stage == NOTE::Off){
+					noteStart[i] = noteOns++;
+					return i;
+				}
+			}
+
+			// no free notes => steal oldest released note?
+			int oldest = -1;
+			unsigned int oldest_start = 0;
+			for (int i = 0; i < count; i++) {
+				if (items[i]->stage == NOTE::Release) {
+					if(oldest == -1 || noteStart[i] < oldest_start){
+						oldest = i;
+						oldest_start = noteStart[i];
+					}
+				}
+			}
+			if(oldest != -1){
+				noteStart[oldest] = noteOns++;
+				return oldest;
+			}
+
+			// no available released notes => steal oldest playing note
+			oldest = -1;
+			oldest_start = 0;
+			for (int i = 0; i < count; i++) {
+				if(oldest == -1 || noteStart[i] < oldest_start){
+					oldest = i;
+					oldest_start = noteStart[i];
+				}
+			}
+			noteStart[oldest] = noteOns++;
+			return oldest;
+		}
+	};
+
+	// base class for synthesiser mini-plugins
+	struct Synth : public Effect {
+		typedef Note Note;
+
+		Notes<Synth, Note> notes;
+
+		Synth() : notes(this) { }
+		virtual ~Synth() { }
+
+		virtual void presetLoaded(int preset) { }
+		virtual void optionChanged(int param, int item) { }
+		virtual void buttonPressed(int param) { };
+
+		int indexOf(Note* note) const {
+			int index = 0;
+			for (const auto* n : notes.items) {
+				if (note == n) return 
+					index;
+				index++;
+			}
+			return -1; // not found
+		}
+	};
+
+	template<class SYNTH, class NOTE>
+	inline Notes<SYNTH, NOTE>::~Notes() {
+		for (unsigned int n = 0; n < count; n++) {
+			NOTE* tmp = items[n];
+			items[n] = nullptr;
+			delete tmp;
+		}
+	}
+
+	namespace Mono { using namespace klang; }
+	namespace mono { using namespace klang; }
+
+	namespace Stereo {
+		typedef signals<2> signal;
+
+		struct frame {
+			mono::signal& l;
+			mono::signal& r;
+
+			frame(mono::signal& left, mono::signal& right) : l(left), r(right) { }
+			frame(signal& signal) : l(signal.l), r(signal.r) { }
+
+			frame& operator+=(const frame& x) { l += x.l; r += x.r; return *this; }
+			frame& operator-=(const frame& x) { l -= x.l; r -= x.r; return *this; }
+			frame& operator*=(const frame& x) { l *= x.l; r *= x.r; return *this; }
+			frame& operator/=(const frame& x) { l /= x.l; r /= x.r; return *this; }
+
+			frame& operator+=(const signal x) { l += x.l; r += x.r; return *this; }
+			frame& operator-=(const signal x) { l -= x.l; r -= x.r; return *this; }
+			frame& operator*=(const signal x) { l *= x.l; r *= x.r; return *this; }
+			frame& operator/=(const signal x) { l /= x.l; r /= x.r; return *this; }
+
+			frame& operator+=(const mono::signal x) { l += x; r += x; return *this; }
+			frame& operator-=(const mono::signal x) { l -= x; r -= x; return *this; }
+			frame& operator*=(const mono::signal x) { l *= x; r *= x; return *this; }
+			frame& operator/=(const mono::signal x) { l /= x; r /= x; return *this; }
+
+			frame& operator+=(float x) { l += x; r += x; return *this; }
+			frame& operator-=(float x) { l -= x; r -= x; return *this; }
+			frame& operator*=(float x) { l *= x; r *= x; return *this; }
+			frame& operator/=(float x) { l /= x; r /= x; return *this; }
+
+			frame& operator+=(double x) { l += (float)x; r += (float)x; return *this; }
+			frame& operator-=(double x) { l -= (float)x; r -= (float)x; return *this; }
+			frame& operator*=(double x) { l *= (float)x; r *= (float)x; return *this; }
+			frame& operator/=(double x) { l /= (float)x; r /= (float)x; return *this; }
+
+			frame& operator+=(int x) { l += (float)x; r += (float)x; return *this; }
+			frame& operator-=(int x) { l -= (float)x; r -= (float)x; return *this; }
+			frame& operator*=(int x) { l *= (float)x; r *= (float)x; return *this; }
+			frame& operator/=(int x) { l /= (float)x; r /= (float)x; return *this; }
+
+			signal operator+(const signal x) const { return { l + x.l, r + x.r }; }
+			signal operator-(const signal x) const { return { l - x.l, r - x.r }; }
+			signal operator*(const signal x) const { return { l * x.l, r * x.r }; }
+			signal operator/(const signal x) const { return { l / x.l, r / x.r }; }
+
+			signal operator+(const mono::signal x) const { return { l + x, r + x }; }
+			signal operator-(const mono::signal x) const { return { l - x, r - x }; }
+			signal operator*(const mono::signal x) const { return { l * x, r * x }; }
+			signal operator/(const mono::signal x) const { return { l / x, r / x }; }
+
+			signal operator+(float x) const { return { l + x, r + x }; }
+			signal operator-(float x) const { return { l - x, r - x }; }
+			signal operator*(float x) const { return { l * x, r * x }; }
+			signal operator/(float x) const { return { l / x, r / x }; }
+
+			signal operator+(double x) const { return { l + (float)x, r + (float)x }; }
+			signal operator-(double x) const { return { l - (float)x, r - (float)x }; }
+			signal operator*(double x) const { return { l * (float)x, r * (float)x }; }
+			signal operator/(double x) const { return { l / (float)x, r / (float)x }; }
+
+			signal operator+(int x) const { return { l + (float)x, r + (float)x }; }
+			signal operator-(int x) const { return { l - (float)x, r - (float)x }; }
+			signal operator*(int x) const { return { l * (float)x, r * (float)x }; }
+			signal operator/(int x) const { return { l / (float)x, r / (float)x }; }
+
+			frame& operator=(const signal& signal) {
+				l = signal.l;
+				r = signal.r;
+				return *this;
+			}
+
+			mono::signal mono() const {
+				return (l + r) * 0.5f;
+			}
+		};
+
+		struct Input : Generic::Input<signal> { };
+		struct Output : Generic::Output<signal> { };
+		struct Generator : Generic::Generator<signal> { };
+		struct Modifier : Generic::Modifier<signal> { };
+		struct Oscillator : Generic::Oscillator<signal> { };
+
+
+
+		inline Modifier& operator>>(signal input, Modifier& modifier) {
+			modifier << input;
+			return modifier;
+		}
+
+		// interleaved access to non-interleaved stereo buffers
+		struct buffer {
+			mono::buffer& left, right;
+
+			buffer(const buffer& buffer) : left(buffer.left), right(buffer.right) { rewind(); }
+			buffer(mono::buffer& left, mono::buffer& right) : left(left), right(right) { rewind(); }
+
+			operator const signal() const { return { left, right }; }
+			operator frame () {				return { left, right }; }
+			operator bool() const {			return left.operator bool() && right.operator bool(); }
+			frame operator++(int) {			return { left++, right++ };	}
+
+			frame operator=(const signal& in) {
+				return { left = in.l, right = in.r };
+			}
+
+			buffer& operator=(const buffer& in) {
+				left = in.left;
+				right = in.right;
+				return *this;
+			}
+
+			buffer& operator+=(const signal& in) {
+				left += in.l;
+				right += in.r;
+				return *this;
+			}
+
+			buffer& operator=(const frame& in) { 		left = in.l;  right = in.r;		return *this;	}
+			buffer& operator+=(const frame& in) {		left += in.l; right += in.r;	return *this;	}
+			buffer& operator*=(const frame& in) {		left *= in.l; right *= in.r;	return *this;	}
+
+			buffer& operator=(const mono::signal in) {		left = in;  right = in;	return *this;	}
+			buffer& operator+=(const mono::signal in) {	left += in; right += in;return *this;	}
+			buffer& operator*=(const mono::signal in) {	left *= in; right *= in;return *this;	}
+
+			frame operator[](int index) {
+				return { left[index], right[index] };
+			}
+
+			mono::buffer& channel(int index) {
+				return index == 1 ? right : left;
+			}
+
+			void clear() {
+				left.clear();
+				right.clear();
+			}
+
+			void clear(int size) {
+				left.clear(size);
+				right.clear(size);
+			}
+
+			void rewind() {
+				left.rewind();
+				right.rewind();
+			}
+		};
+
+		struct Effect : public Plugin, public Modifier {
+			virtual ~Effect() { }
+
+			virtual void prepare() { };
+			virtual void process() { out = in; };
+			virtual void process(Stereo::buffer buffer) {
+				prepare();
+				while (buffer) {
+					input(buffer);
+					process();
+					buffer++ = out;
+					debug++;
+				}
+			}
+		};
+
+		struct Synth;
+
+		// stereo note object
+		struct Note : public NoteBase<Synth>, public Generator { 
+			//virtual signal output() { return 0; };
+
+			virtual void prepare() { }
+			virtual void process() override = 0;
+			virtual bool process(Stereo::buffer buffer) {
+				prepare();
+				while (buffer) {
+					process();
+					buffer++ = out;
+				}
+				return !finished();
+			}
+			virtual bool process(mono::buffer* buffers) {
+				buffer buffer = { buffers[0], buffers[1] };
+				return process(buffer);
+			}
+		};
+
+		// base class for stereo synthesiser mini-plugins
+		struct Synth : public Effect {
+			typedef Stereo::Note Note;
+
+			struct Notes : klang::Notes<Synth, Note> {
+				using klang::Notes<Synth, Note>::Notes;
+			} notes;
+
+			Synth() : notes(this) { }
+			virtual ~Synth() { }
+
+			virtual void presetLoaded(int preset) { }
+			virtual void optionChanged(int param, int item) { }
+			virtual void buttonPressed(int param) { };
+
+			int indexOf(Note* note) const {
+				int index = 0;
+				for (const auto* n : notes.items) {
+					if (note == n) return
+						index;
+					index++;
+				}
+				return -1; // not found
+			}
+		};
+	}
+
+	namespace stereo {
+		using namespace Stereo;
+	}
+
+	// multi-channel signals, buffers and plugins (e.g. 5.1, 7.1 or ambisonic; see Stereo)
+	template<int CHANNELS>
+	struct Multi {
+		static constexpr int BLOCK = 64; // frames processed per block
+
+		typedef lanes<CHANNELS> signal; // one lane per channel (vectorised per-frame operators)
+
+		// frame (all channels) at a position in a non-interleaved multi-channel buffer
+		struct frame {
+			float* const* channels;
+			const int index;
+
+			frame(float* const* channels, int index) : channels(channels), index(index) { }
+
+			float& operator[](int channel) { return channels[channel][index]; }
+			float operator[](int channel) const { return channels[channel][index]; }
+
+			operator signal() const { signal x; for (int c = 0; c < CHANNELS; c++) x[c] = channels[c][index]; return x; }
+
+			frame& operator=(const signal& x) {	for (int c = 0; c < CHANNELS; c++) channels[c][index] = x[c];	return *this; }
+			frame& operator+=(const signal& x) {	for (int c = 0; c < CHANNELS; c++) channels[c][index] += x[c];	return *this; }
+			frame& operator*=(const signal& x) {	for (int c = 0; c < CHANNELS; c++) channels[c][index] *= x[c];	return *this; }
+
+			frame& operator=(const klang::signal x) {	for (int c = 0; c < CHANNELS; c++) channels[c][index] = x;	return *this; }
+			frame& operator+=(const klang::signal x) {	for (int c = 0; c < CHANNELS; c++) channels[c][index] += x;	return *this; }
+			frame& operator*=(const klang::signal x) {	for (int c = 0; c < CHANNELS; c++) channels[c][index] *= x;	return *this; }
+
+			klang::signal mono() const {
+				float sum = 0;
+				for (int c = 0; c < CHANNELS; c++)
+					sum += channels[c][index];
+				return sum * (1.f / CHANNELS);
+			}
+		};
+
+		struct Input : Generic::Input<signal> { };
+		struct Output : Generic::Output<signal> { };
+		struct Generator : Generic::Generator<signal> { };
+		struct Modifier : Generic::Modifier<signal> { };
+		struct Oscillator : Generic::Oscillator<signal> { };
+
+		// non-interleaved multi-channel buffer (host channels or owned, aligned storage)
+		struct buffer {
+			float* channels[CHANNELS];
+			const int size;
+		protected:
+			std::shared_ptr<float> storage;	// owned storage (from Pool; contiguous, aligned channels)
+			int position = 0;
+		public:
+			buffer(mono::buffer* buffers) : size(buffers[0].size) {
+				for (int c = 0; c < CHANNELS; c++)
+					channels[c] = (float*)&buffers[c][0];
+			}
+
+			buffer(float* const* channels, int size) : size(size) {
+				for (int c = 0; c < CHANNELS; c++)
+					buffer::channels[c] = channels[c];
+			}
+
+			buffer(int size) : size(size) {
+				const int stride = Pool::align(size);
+				storage = Pool::current().allocate(stride * CHANNELS);
+				float* samples = storage.get();
+				for (int c = 0; c < CHANNELS; c++)
+					channels[c] = samples + c * stride;
+				clear();
+			}
+
+			float* channel(int index) { return channels[index]; }
+			const float* channel(int index) const { return channels[index]; }
+
+			operator bool() const {		return position < size; }
+			frame operator++(int) {		return { channels, position++ }; }
+			operator frame() {			return { channels, position }; }
+			frame operator[](int index) {	return { channels, index }; }
+
+			frame operator=(const signal& in) {			return frame(channels, position) = in;	}
+			frame operator+=(const signal& in) {		return frame(channels, position) += in;	}
+			frame operator=(const klang::signal in) {	return frame(channels, position) = in;	}
+			frame operator+=(const klang::signal in) {	return frame(channels, position) += in;	}
+
+			// gathers frames (from offset) into an interleaved block
+			void read(int offset, signal* frames, int count) const {
+				for (int c = 0; c < CHANNELS; c++) {
+					const float* samples = channels[c] + offset;
+					for (int s = 0; s < count; s++)
+						frames[s][c] = samples[s];
+				}
+			}
+
+			// scatters an interleaved block of frames (to offset)
+			void write(int offset, const signal* frames, int count) {
+				for (int c = 0; c < CHANNELS; c++) {
+					float* samples = channels[c] + offset;
+					for (int s = 0; s < count; s++)
+						samples[s] = frames[s][c];
+				}
+			}
+
+			void clear() {
+				clear(size);
+			}
+
+			void clear(int size) {
+				for (int c = 0; c < CHANNELS; c++)
+					memset(channels[c], 0, sizeof(float) * (size < buffer::size ? size : buffer::size));
+			}
+
+			void rewind() {
+				position = 0;
+			}
+		};
+
+		struct Effect : public Plugin, public Modifier {
+			using Modifier::out;
+			virtual ~Effect() { }
+
+			virtual void prepare() { };
+			virtual void process() { out = Modifier::in; };
+			virtual void process(Multi::buffer buffer) {
+				prepare();
+				signal frames[BLOCK];
+				for (int offset = 0; offset < buffer.size; offset += BLOCK) {
+					const int count = std::min(int(BLOCK), buffer.size - offset);
+					buffer.read(offset, frames, count);
+					process(frames, frames, count);
+					buffer.write(offset, frames, count);
+				}
+			}
+			virtual void process(const signal* inputs, signal* outputs, int samples) override {
+				for (int s = 0; s < samples; s++) {
+					Modifier::input(inputs[s]);
+					process();
+					outputs[s] = out;
+					debug++;
+				}
+			}
+		};
+
+		struct Synth;
+
+		// multi-channel note object
+		struct Note : public NoteBase<Synth>, public Generator {
+			using Generator::out;
+
+			virtual void prepare() { }
+			virtual void process() override = 0;
+			virtual bool process(Multi::buffer buffer) {
+				prepare();
+				signal frames[BLOCK];
+				for (int offset = 0; offset < buffer.size; offset += BLOCK) {
+					const int count = std::min(int(BLOCK), buffer.size - offset);
+					process(frames, count);
+					buffer.write(offset, frames, count);
+				}
+				return !NoteBase<Synth>::finished();
+			}
+			virtual bool process(mono::buffer* buffers) {
+				return process(Multi::buffer(buffers));
+			}
+			virtual void process(signal* outputs, int samples) override {
+				for (int s = 0; s < samples; s++) {
+					process();
+					outputs[s] = out;
+				}
+			}
+		};
+
+		// base class for multi-channel synthesiser mini-plugins
+		struct Synth : public Effect {
+			typedef typename Multi::Note Note;
+
+			struct Notes : klang::Notes<Synth, Note> {
+				using klang::Notes<Synth, Note>::Notes;
+			} notes;
+
+			Synth() : notes(this) { }
+			virtual ~Synth() { }
+
+			virtual void presetLoaded(int preset) { }
+			virtual void optionChanged(int param, int item) { }
+			virtual void buttonPressed(int param) { };
+
+			int indexOf(Note* note) const {
+				int index = 0;
+				for (const auto* n : notes.items) {
+					if (note == n) return
+						index;
+					index++;
+				}
+				return -1; // not found
+			}
+		};
+	};
+
+	template<int CHANNELS>
+	inline typename Multi<CHANNELS>::Modifier& operator>>(lanes<CHANNELS> input, typename Multi<CHANNELS>::Modifier& modifier) {
+		modifier << input;
+		return modifier;
+	}
+
+	namespace Oscillators {
+		using namespace klang;
+
+		namespace Basic {
+			// oscillator with an integer phase accumulator (no drift from float accumulation)
+			struct Oscillator : public klang::Oscillator {
+				void reset() override {
+					klang::Oscillator::reset();
+					phase = 0.f;
+				}
+
+				void set(param frequency) override {
+					klang::Oscillator::set(frequency);
+					delta = accumulator::frequency(frequency);
+				}
+
+				void set(param frequency, param phase) override {
+					klang::Oscillator::set(frequency, phase);
+					Oscillator::phase = accumulator(phase);
+				}
+
+				using klang::Oscillator::set;
+
+			protected:
+				accumulator phase, delta;
+			};
+
+			struct Sine : public Oscillator {
+				void process() {
+					out = sin(phase.radians() + offset);
+					phase += delta;
+				}
+			};
+
+			struct Saw : public Oscillator {
+				void process() {
+					out = phase.cycles() * 2.f - 1.f;
+					phase += delta;
+				}
+			};
+		};
+
+		namespace Fast {
+			constexpr float pi = 3.1415926535897932384626433832795f;
+			constexpr float twoPi = float(2.0 * 3.1415926535897932384626433832795);
+			constexpr float twoPiInv = float(1.0 / twoPi);
+
+			struct Increment {
+				// represent phase delta using full range of int32
+				// (integer math, no conditionals, free oversampling)
+				signed int amount = 0;
+
+				void reset() { amount = 0; }
+
+				// set increment given frequency (in Hz)
+				void set(Frequency f) {
+					amount = (signed int)phase<float, unsigned int>::frequency(f).i; // (rounded to nearest, via double)
+				}
+
+				// convert int32 to float [0, 2pi)
+				operator float() const {
+					const unsigned int i = (amount >> 9) | 0x3f800000;
+					return *(const float*)&i - 1.f;
+				}
+
+				Increment operator+(const Increment& in) const {
+					return { in.amount + amount };
+				}
+			};
+
+			struct Phase {
+				// represent phase using full range of uint32
+				// (integer math, no conditionals, free oversampling)
+				unsigned int position = 0;
+
+				// convert radians to uint32 ([0, 2pi) = full range; other values wrap)
+				Phase& operator=(klang::Phase phase) {
+					constexpr double SCALE = 4294967296.0 / (2.0 * 3.1415926535897932384626433832795);
+					position = (unsigned int)(long long)(double(phase.value) * SCALE);
+					return *this;
+				}
+
+				// convert uint32 to float [0, 1)
+				operator float() const {
+					const unsigned int i = (position >> 9) | 0x3f800000;
+					return (*(const float*)&i - 1.f);
+
+					//// = quarter-turn (pi/2) phase offset
+					//unsigned int phase = position + 0x40000000;
+
+					//// range reduce to [0,pi]
+					//if (phase & 0x80000000) // cos(x) = cos(-x)
+					//	phase = ~phase; 
+
+					//// convert to float in range [-pi/2,pi/2)
+					//phase = (phase >> 8) | 0x3f800000;
+					//return *(float*)&phase * pi - 3.f/2.f * pi; // 1.0f + (phase / (2^31))
+				}
+
+				// returns offset phase
+				float operator+(const Phase& offset) const {
+					
+					unsigned int phase = (position + offset.position) + 0x40000000; // = quarter-turn (pi/2) phase offset
+					// range reduce to [0,pi]
+					if (phase & 0x80000000) // cos(x) = cos(-x)
+						phase = ~phase;
+
+					// convert to float in range [-pi/2,pi/2)
+					phase = (phase >> 8) | 0x3f800000;
+					return *(float*)&phase * pi - 3.f / 2.f * pi; // 1.0f + (phase / (2^31))
+				}
+
+				// convert uint32 to float [0, 2pi)
+				float radians() const {
+					return operator float();
+				}
+
+				// applies increment and returns float [0, 2pi)
+				//float operator+=(Increment i) {
+				//	unsigned int phase = position + 0x40000000; // = quarter-turn (pi/2) phase offset
+				//	position += i.amount;						// apply increment
+
+				//	// range reduce to [0,pi]
+				//	if (phase & 0x80000000) // cos(x) = cos(-x)
+				//		phase = ~phase;
+
+				//	// convert to float in range [-pi/2,pi/2)
+				//	phase = (phase >> 8) | 0x3f800000;
+				//	return *(float*)&phase * pi - 3 / 2.f * pi; // 1.0f + (phase / (2^31))
+				//}
+
+				// applies increment and returns float [0, 2pi)
+				Phase& operator+=(const Increment i) {
+					position += i.amount;						// apply increment
+					return *this;
+				}
+
+				// applies increment and returns float [0, 2pi)
+				//Phase operator+(const Phase& i) const {
+				//	return { position + i.position };				// apply increment
+				//}
+
+				//// applies increment and returns float [0, 2pi)
+				//float operator+=(Increment i) {
+				//	unsigned int phase = position + 0x40000000; // = quarter-turn (pi/2) phase offset
+				//	position += i.amount;						// apply increment
+
+				//	// range reduce to [0,pi]
+				//	if (phase & 0x80000000) // cos(x) = cos(-x)
+				//		phase = ~phase; 
+
+				//	// convert to float in range [-pi/2,pi/2)
+				//	phase = (phase >> 8) | 0x3f800000;
+				//	return *(float*)&phase * pi - 3/2.f * pi; // 1.0f + (phase / (2^31))
+				//}
+
+				//Phase& operator+(Phase offset) const {
+				//	offset.position += position;
+				//	return offset;
+				//}
+
+				//static void test() {
+				//	Phase p;
+				//	assert((float)(p = 0.f).radians() == 0.f);
+				//	assert((float)(p = pi/2).radians() == pi/2);
+				//	assert((float)(p = pi).radians() == pi);
+				//	assert((float)(p = 3*pi/2).radians() == 3*pi/2);
+				//	assert((float)(p = 2*pi).radians() == 0.f);
+				//}
+			};
+
+			// sin approximation [-pi/2, pi/2] using odd minimax polynomial (Robin Green)
+			inline static float polysin(float x) {
+				const float x2 = x * x;
+				return (((-0.00018542f * x2 + 0.0083143f) * x2 - 0.16666f) * x2 + 1.0f) * x;
+			}
+
+			// fast sine (based on V2/Farbrausch; using polysin)
+			inline static float fastsin(float x)
+			{
+				// Range reduction to [0, 2pi]
+				//x = fmodf(x, twoPi);
+				//if (x < 0)			// support -ve phase (e.g. for FM)
+				//	x += twoPi;		//
+				x = fast_mod2pi(x);
+
+				// Range reduction to [-pi/2, pi/2]
+				if (x > 3/2.f * pi)	// 3/2pi ... 2pi
+					x -= twoPi;	// (= translated)
+				else if (x > pi/2)	// pi/2 ... 3pi/2
+					x = pi - x;		// (= mirrored)
+  
+				return polysin(x);
+			}
+
+			// fast sine (using polysin and integer math)
+			inline static float fastsinp(unsigned int p)
+			{
+				// Range reduction to [0, 2pi]
+				//x = fmodf(x, twoPi);
+				//if (x < 0)			// support -ve phase (e.g. for FM)
+				//	x += twoPi;		//
+				float x = fast_modp(p);
+
+				// Range reduction to [-pi/2, pi/2]
+				if (x > 3.f/2.f * pi)	// 3/2pi ... 2pi
+					x -= twoPi;			// (= translated)
+				else if (x > pi/2.f)	// pi/2 ... 3pi/2
+					x = pi - x;			// (= mirrored)
+
+				return polysin(x);
+			}
+
+			// fast sine (using polysin and integer math; branch-free range reduction)
+			inline static float fastsini(unsigned int p)
+			{
+				// Range reduction to [-pi/2, pi/2]
+				p += 0x40000000;						// = quarter-turn (pi/2) phase offset
+				p ^= (unsigned int)((signed int)p >> 31);	// mirror [pi, 2pi) to [0, pi) (cos(x) = cos(-x))
+
+				// convert to float in range [-pi/2, pi/2)
+				p = (p >> 8) | 0x3f800000;
+				return polysin(bit_cast<float>(p) * pi - 3.f / 2.f * pi);
+			}
+
+#if defined(KLANG_AVX2)
+			// fast sine of 8 phases (see fastsini)
+			inline static __m256 fastsini(__m256i p) {
+				p = _mm256_add_epi32(p, _mm256_set1_epi32(0x40000000));
+				p = _mm256_xor_si256(p, _mm256_srai_epi32(p, 31));
+				p = _mm256_or_si256(_mm256_srli_epi32(p, 8), _mm256_set1_epi32(0x3f800000));
+				const __m256 x = _mm256_sub_ps(_mm256_mul_ps(_mm256_castsi256_ps(p), _mm256_set1_ps(pi)), _mm256_set1_ps(3.f / 2.f * pi));
+				const __m256 x2 = _mm256_mul_ps(x, x);
+				__m256 y = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(-0.00018542f), x2), _mm256_set1_ps(0.0083143f));
+				y = _mm256_add_ps(_mm256_mul_ps(y, x2), _mm256_set1_ps(-0.16666f));
+				y = _mm256_add_ps(_mm256_mul_ps(y, x2), _mm256_set1_ps(1.0f));
+				return _mm256_mul_ps(y, x);
+			}
+#endif
+#if defined(KLANG_SSE2)
+			// fast sine of 4 phases (see fastsini)
+			inline static __m128 fastsini(__m128i p) {
+				p = _mm_add_epi32(p, _mm_set1_epi32(0x40000000));
+				p = _mm_xor_si128(p, _mm_srai_epi32(p, 31));
+				p = _mm_or_si128(_mm_srli_epi32(p, 8), _mm_set1_epi32(0x3f800000));
+				const __m128 x = _mm_sub_ps(_mm_mul_ps(_mm_castsi128_ps(p), _mm_set1_ps(pi)), _mm_set1_ps(3.f / 2.f * pi));
+				const __m128 x2 = _mm_mul_ps(x, x);
+				__m128 y = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.00018542f), x2), _mm_set1_ps(0.0083143f));
+				y = _mm_add_ps(_mm_mul_ps(y, x2), _mm_set1_ps(-0.16666f));
+				y = _mm_add_ps(_mm_mul_ps(y, x2), _mm_set1_ps(1.0f));
+				return _mm_mul_ps(y, x);
+			}
+#elif defined(KLANG_NEON)
+			// fast sine of 4 phases (see fastsini)
+			inline static float32x4_t fastsini(uint32x4_t p) {
+				p = vaddq_u32(p, vdupq_n_u32(0x40000000));
+				p = veorq_u32(p, vreinterpretq_u32_s32(vshrq_n_s32(vreinterpretq_s32_u32(p), 31)));
+				p = vorrq_u32(vshrq_n_u32(p, 8), vdupq_n_u32(0x3f800000));
+				const float32x4_t x = vsubq_f32(vmulq_n_f32(vreinterpretq_f32_u32(p), pi), vdupq_n_f32(3.f / 2.f * pi));
+				const float32x4_t x2 = vmulq_f32(x, x);
+				float32x4_t y = vaddq_f32(vmulq_n_f32(x2, -0.00018542f), vdupq_n_f32(0.0083143f));
+				y = vaddq_f32(vmulq_f32(y, x2), vdupq_n_f32(-0.16666f));
+				y = vaddq_f32(vmulq_f32(y, x2), vdupq_n_f32(1.0f));
+				return vmulq_f32(y, x);
+			}
+#endif
+
+			// renders a block of a sine oscillator (from phase, advancing by increment per sample)
+			inline static void fastsin_block(unsigned int phase, unsigned int increment, float* outputs, int samples)
+			{
+				int s = 0;
+#if defined(KLANG_AVX2)
+				__m256i p = _mm256_setr_epi32(phase, phase + increment, phase + 2 * increment, phase + 3 * increment, 
+											  phase + 4 * increment, phase + 5 * increment, phase + 6 * increment, phase + 7 * increment);
+				const __m256i step = _mm256_set1_epi32(8 * increment);
+				for (; s + 8 <= samples; s += 8) {
+					_mm256_storeu_ps(outputs + s, fastsini(p));
+					p = _mm256_add_epi32(p, step);
+				}
+#elif defined(KLANG_SSE2)
+				__m128i p = _mm_setr_epi32(phase, phase + increment, phase + 2 * increment, phase + 3 * increment);
+				const __m128i step = _mm_set1_epi32(4 * increment);
+				for (; s + 4 <= samples; s += 4) {
+					_mm_storeu_ps(outputs + s, fastsini(p));
+					p = _mm_add_epi32(p, step);
+				}
+#elif defined(KLANG_NEON)
+				const unsigned int init[4] = { phase, phase + increment, phase + 2 * increment, phase + 3 * increment };
+				uint32x4_t p = vld1q_u32(init);
+				const uint32x4_t step = vdupq_n_u32(4 * increment);
+				for (; s + 4 <= samples; s += 4) {
+					vst1q_f32(outputs + s, fastsini(p));
+					p = vaddq_u32(p, step);
+				}
+#endif
+				for (phase += s * increment; s < samples; s++, phase += increment)
+					outputs[s] = fastsini(phase);
+			}
+
+			// renders one sample of each oscillator in a bank of sine oscillators (and advances their phases)
+			inline static void fastsin_bank(unsigned int* phases, const unsigned int* increments, float* outputs, int count)
+			{
+				int o = 0;
+#if defined(KLANG_AVX2)
+				for (; o + 8 <= count; o += 8) {
+					const __m256i p = _mm256_loadu_si256((const __m256i*)(phases + o));
+					_mm256_storeu_ps(outputs + o, fastsini(p));
+					_mm256_storeu_si256((__m256i*)(phases + o), _mm256_add_epi32(p, _mm256_loadu_si256((const __m256i*)(increments + o))));
+				}
+#endif
+#if defined(KLANG_SSE2)
+				for (; o + 4 <= count; o += 4) {
+					const __m128i p = _mm_loadu_si128((const __m128i*)(phases + o));
+					_mm_storeu_ps(outputs + o, fastsini(p));
+					_mm_storeu_si128((__m128i*)(phases + o), _mm_add_epi32(p, _mm_loadu_si128((const __m128i*)(increments + o))));
+				}
+#elif defined(KLANG_NEON)
+				for (; o + 4 <= count; o += 4) {
+					const uint32x4_t p = vld1q_u32(phases + o);
+					vst1q_f32(outputs + o, fastsini(p));
+					vst1q_u32(phases + o, vaddq_u32(p, vld1q_u32(increments + o)));
+				}
+#endif
+				for (; o < count; o++) {
+					outputs[o] = fastsini(phases[o]);
+					phases[o] += increments[o];
+				}
+			}
+
+			// renders a block of a sine oscillator from a phase accumulator (matching per-sample stepping at any width)
+			template<typename ACCUMULATOR>
+			inline static void fastsin_block(const ACCUMULATOR& position, const ACCUMULATOR& increment, unsigned int offset, float* outputs, int samples)
+			{
+				if constexpr (ACCUMULATOR::BITS == 32) {
+					fastsin_block(position.top() + offset, increment.top(), outputs, samples);
+				} else { // (wider phases step in full precision, then the 32-bit kernel evaluates each phase)
+					constexpr int CHUNK = 64;
+					static const unsigned int hold[CHUNK] = { 0 };
+					unsigned int phases[CHUNK];
+					ACCUMULATOR p = position;
+					for (int s = 0; s < samples; s += CHUNK) {
+						const int n = std::min(CHUNK, samples - s);
+						p.tops(increment, offset, phases, n);
+						fastsin_bank(phases, hold, outputs + s, n);
+						p += increment * (unsigned int)n;
+					}
+				}
+			}
+
+			struct Sine : public Oscillator {
+				void reset() override {
+					Sine::position = accumulator();
+					Oscillator::position = 0;
+					Sine::offset = Oscillator::offset = 0;
+					set(Oscillator::frequency, 0.f);
+				}
+
+				// set the frequency
+				void set(param frequency) override {
+					if (frequency != Oscillator::frequency) {
+						Oscillator::frequency = frequency;
+						increment = accumulator::frequency(frequency);
+					}
+				}
+
+				void set(param frequency, param phase) override { // set frequency and phase
+					Oscillator::position = phase;
+					Fast::Phase p;
+					p = phase; // (as Fast::Phase)
+					Sine::position = accumulator::fixed(p.position);
+					Sine::offset = Oscillator::offset = 0;
+					set(frequency);
+				}
+
+				void set(param frequency, relative phase) override { // set frequency and phase
+					set(frequency);
+					set(phase);
+				}
+
+				void set(relative phase) override { // set frequency and phase
+					Sine::offset = Oscillator::offset = phase * twoPi;
+				}
+
+				void process() override {
+					out = fastsini(position.top() + offset.position);
+					position += increment;
+				}
+
+				void process(signal* outputs, int samples) override {
+					fastsin_block(position, increment, offset.position, (float*)outputs, samples);
+					position += increment * (unsigned int)samples;
+					if (samples)
+						out = outputs[samples - 1];
+				}
+
+			protected:
+				accumulator position, increment;
+				Fast::Phase offset;
+			};
+
+			struct OSM {
+				enum State { // carry:old_up:new_up
+					NewUp = 0b001, NewDown = 0b000,
+					OldUp = 0b010, OldDown = 0b000,
+					Carry = 0b100, NoCarry = 0b000,
+
+					Down		= OldDown|NewDown|NoCarry,  
+					UpDown		= OldUp|NewDown|NoCarry,    
+					Up			= OldUp|NewUp|NoCarry,		
+					DownUpDown	= OldDown|NewDown|Carry,	
+					DownUp		= OldDown|NewUp|Carry,		
+					UpDownUp	= OldUp|NewUp|Carry			
+				};
+
+				Fast::Increment increment;
+				Fast::Phase offset;
+				Fast::Phase duty;
+				State state;
+				float delta;
+
+				void init() {
+					state = (offset.position - increment.amount) < duty.position ? Up : Down;
+				}
+				
+				void set(param frequency) {
+					//if (frequency != Oscillator::frequency) {
+					//	Oscillator::frequency = frequency;
+						increment.set(frequency);
+						delta = increment;
+						init();
+					//}
+				}
+
+				void set(param frequency, param phase) {
+					increment.set(frequency);
+					delta = increment;
+					offset = phase;
+					init();
+				}
+
+				void set(param frequency, param phase, param duty) {
+					increment.set(frequency);
+					delta = increment;
+					offset = phase;
+					OSM::duty = duty * pi;
+					init();
+				}
+
+				State tick() {
+					// old_up = new_up, new_up = (cnt < brpt)
+					state = (State)(((state << 1) | (offset.position < duty.position)) & (NewUp|OldUp));
+
+					// we added freq to cnt going from the previous sample to the current one.
+					// so if cnt is less than freq, we carried.
+					const State transition = (State)(state | (offset.position < (unsigned int)increment.amount ? DownUpDown : Down)); 
+
+					// finally, tick the oscillator
+					offset += increment;
+
+					return transition;
+				}
+
+				static float sqr(float x) { return x * x; }
+
+				float output() {
+					const float f = delta;
+					const float omf = 1.f - f;
+					const float rcpf = 1.f / f;
+					const float col = duty;
+
+					const float c1 = 1.f / col;
+					const float c2 = -1.f / (1.0f - col);
+
+					float p = offset - col;
+					float y = 0.0f;
+
+					// state machine action
+					switch (tick())
+					{
+					case Up:
+						// average of linear function = just sample in the middle
+						y = c1 * (p + p - f);
+						break;
+
+					case Down:
+						// again, average of a linear function
+						y = c2 * (p + p - f);
+						break;
+
+					case UpDown:
+						y = rcpf * (c2 * sqr(p) - c1 * sqr(p - f));
+						break;
+
+					case DownUp:
+						y = -rcpf * (1.f + c2 * sqr(p + omf) - c1 * sqr(p));
+						break;
+
+					case UpDownUp:
+						y = -rcpf * (1.f + c1 * omf * (p + p + omf));
+						break;
+
+					case DownUpDown:
+						y = -rcpf * (1.f + c2 * omf * (p + p + omf));
+						break;
+
+					default:
+						assert(false);
+					}
+
+					return y + 1.f;
+				}
+			};
+
+			struct Saw : public Oscillator {
+				void set(param frequency) {
+					osm.set(frequency);
+				}
+
+				void set(param frequency, param phase) {
+					osm.set(frequency, phase);
+				}
+
+				void set(param frequency, param phase, param duty) {
+					osm.set(frequency, phase, duty);
+				}
+
+				void process() {
+					out = osm.output();
+				}
+
+				void process(signal* outputs, int samples) override {
+					for (int s = 0; s < samples; s++)
+						outputs[s] = osm.output();
+					if (samples)
+						out = outputs[samples - 1];
+				}
+
+			protected:
+				OSM osm;
+			};
+		};
+
+		// band-limited oscillators (polynomial BLEP/BLAMP corrections of the naive waveforms)
+		// - set(frequency, phase, duty): phase in radians, duty as fraction of a cycle [0, 1]
+		// - branch-free (abs rather than min/max/compare), so block rendering vectorises
+		namespace PolyBLEP {
+			// convert uint32 phase to float [0, 1) (exact, 24-bit)
+			inline float fraction(unsigned int phase) {
+				return float(int(phase >> 8)) * (1.f / 16777216.f);
+			}
+
+			// max(x, 0), without a compare
+			inline float positive(float x) {
+				return 0.5f * (x + fabsf(x));
+			}
+
+			// residual of a rising (-1 to +1) step at phase 0 (t = phase, rcp = 1 / increment, in cycles)
+			inline float blep(float t, float rcp) {
+				const float a = positive(1.f - t * rcp);			// just after the step
+				const float b = positive(1.f - (1.f - t) * rcp);	// just before the step
+				return b * b - a * a;
+			}
+
+			// residual of a unit increase in slope at phase 0 (scale by the slope change x increment)
+			inline float blamp(float t, float rcp) {
+				const float a = positive(1.f - t * rcp);
+				const float b = positive(1.f - (1.f - t) * rcp);
+				return (a * a * a + b * b * b) * (1.f / 3.f);
+			}
+
+			// duty cycle (as phase offset of the second edge/corner, and derived slopes)
+			struct Duty {
+				unsigned int width;
+				float fraction, up, down;
+
+				Duty(float duty = 0.5f) {
+					constexpr float MIN = 1.f / 4096.f;
+					duty = duty < MIN ? MIN : duty > 1.f - MIN ? 1.f - MIN : duty;
+					width = (unsigned int)(duty * 4294967296.0);
+					fraction = PolyBLEP::fraction(width);
+					up = 2.f / fraction;
+					down = 2.f / (1.f - fraction);
+				}
+			};
+
+			// oscillator rendering SHAPE::render(t, t2, dt, rcp, duty) per sample
+			// (t = phase, t2 = phase - duty, dt = increment, rcp = 1 / dt; in cycles)
+			template<typename SHAPE>
+			struct Oscillator : public Basic::Oscillator {
+				using Basic::Oscillator::set;
+
+				void set(param frequency, param phase, param duty) {
+					set(frequency, phase);
+					setDuty(duty);
+				}
+
+				// set the duty cycle (e.g. at audio rate, for PWM)
+				void setDuty(param duty) {
+					Oscillator::duty = Duty(duty);
+				}
+
+				void process() {
+					const unsigned int p = phase.top();
+					const float dt = increment();
+					out = SHAPE::render(fraction(p), fraction(p - duty.width), dt, 1.f / dt, duty);
+					phase += delta;
+				}
+
+				void process(signal* outputs, int samples) override {
+					const Duty duty = Oscillator::duty;
+					const float dt = increment(), rcp = 1.f / dt;
+					float* const output = (float*)outputs;
+					accumulator p = phase; // (stepped at full width, as per sample)
+					for (int s = 0; s < samples; s++, p += delta) {
+						const unsigned int q = p.top();
+						output[s] = SHAPE::render(fraction(q), fraction(q - duty.width), dt, rcp, duty);
+					}
+					phase = p;
+					if (samples)
+						out = outputs[samples - 1];
+				}
+
+			protected:
+				Duty duty;
+
+				float increment() const {
+					return std::max(fraction(delta.top()), 1.f / 16777216.f);
+				}
+			};
+
+			// saw (duty is ignored)
+			struct Saw : public Oscillator<Saw> {
+				static float render(float t, float, float, float rcp, const Duty&) {
+					return 2.f * t - 1.f - blep(t, rcp);
+				}
+			};
+
+			// pulse (duty = width of the high part)
+			struct Pulse : public Oscillator<Pulse> {
+				static float render(float t, float t2, float, float rcp, const Duty& duty) {
+					return 2.f * (duty.fraction - t + t2) - 1.f + blep(t, rcp) - blep(t2, rcp);
+				}
+			};
+
+			// square (pulse with 50% duty, by default)
+			struct Square : public Pulse { };
+
+			// triangle (duty = position of the peak; 0.5 = symmetric, towards 0 or 1 = saw)
+			struct Triangle : public Oscillator<Triangle> {
+				static float render(float t, float t2, float dt, float rcp, const Duty& duty) {
+					const float rise = t * duty.up, fall = (1.f - t) * duty.down;
+					const float y = 0.5f * (rise + fall - fabsf(rise - fall)) - 1.f;		// min(rise, fall) - 1
+					return y + (duty.up + duty.down) * dt * (blamp(t, rcp) - blamp(t2, rcp));
+				}
+			};
+		};
+
+		// stack of N detuned oscillators (e.g. supersaw), rendered together with stereo spread
+		// - phases, increments and duties are stored per voice (structure-of-arrays)
+		// - OSC selects the waveform: Fast::Saw (saw-triangle morph, via duty) or Fast::Sine
+		// - saws are anti-aliased by differentiating the waveform's integral (box filter, branch-free)
+		template<typename OSC, int N>
+		struct Unison : public Stereo::Oscillator {
+			static_assert(std::is_same<OSC, Fast::Saw>() || std::is_same<OSC, Fast::Sine>(), "Unison supports Fast::Saw or Fast::Sine");
+			static constexpr int BLOCK = 64;	// samples rendered per voice pass
+
+			using Stereo::Oscillator::set;
+			using Stereo::Oscillator::process;
+
+			Unison() {
+				for (int v = 0; v < N; v++)
+					setDuty(v, 0.f);
+				setSpread(1.f);
+			}
+
+			void reset() override {
+				set(Oscillator::frequency, 0.f);
+			}
+
+			// set the detune (fractional frequency deviation of the outer voices, e.g. 0.01 = 1%)
+			void setDetune(param amount) {
+				detune = amount;
+				set(Oscillator::frequency);
+			}
+
+			// set the stereo spread (0 = mono, 1 = outer voices hard-panned)
+			void setSpread(param width) {
+				for (int v = 0; v < N; v++) {
+					const float pan = width * spread(v);
+					left[v] = (1.f - pan) * (1.f / N);
+					right[v] = (1.f + pan) * (1.f / N);
+				}
+			}
+
+			// set the duty of one voice (saw-triangle morph; 0 = saw, 1 = triangle, as Fast::Saw)
+			void setDuty(int voice, param duty) {
+				constexpr float MIN = 1.f / 4096.f;
+				const float d = std::min(std::max(0.5f * duty, MIN), 1.f - MIN); // (peak position)
+				Unison::duty[voice] = d;
+				rise[voice] = 1.f / d;
+				fall[voice] = 1.f / (1.f - d);
+				integral[voice] = G(fraction(phase[voice] - increment[voice]), voice);
+			}
+
+			void set(param frequency) override {
+				Oscillator::frequency = frequency;
+				for (int v = 0; v < N; v++) {
+					Fast::Increment i;
+					i.set(frequency * (1.f + detune * spread(v)));
+					increment[v] = (unsigned int)i.amount;
+					cycles[v] = std::max(fraction(increment[v]), 1.f / 4294967296.f);
+					rcp[v] = 1.f / cycles[v];
+				}
+			}
+
+			// set the frequency and phase (in radians) of all voices
+			void set(param frequency, param phase) override {
+				set(frequency);
+				Fast::Phase p;
+				p = phase;
+				for (int v = 0; v < N; v++) {
+					Unison::phase[v] = p.position;
+					integral[v] = G(fraction(p.position - increment[v]), v);
+				}
+			}
+
+			// set the frequency, phase and duty (saw-triangle morph) of all voices
+			void set(param frequency, param phase, param duty) override {
+				for (int v = 0; v < N; v++)
+					setDuty(v, duty);
+				set(frequency, phase);
+			}
+
+			void process() override {
+				float l, r;
+				render(&l, &r, 1);
+				out.l = l;
+				out.r = r;
+			}
+
+			void process(Stereo::signal* outputs, int samples) override {
+				alignas(32) float l[BLOCK], r[BLOCK];
+				for (int s = 0; s < samples; s += BLOCK) {
+					const int block = std::min(BLOCK, samples - s);
+					render(l, r, block);
+					for (int b = 0; b < block; b++) {
+						outputs[s + b].l = l[b];
+						outputs[s + b].r = r[b];
+					}
+				}
+				if (samples)
+					out = outputs[samples - 1];
+			}
+
+			// renders (non-interleaved) left and right channels
+			void render(float* l, float* r, int samples) {
+				alignas(32) float y[BLOCK];
+				for (int s = 0; s < samples; s += BLOCK) {
+					const int block = std::min(BLOCK, samples - s);
+					for (int b = 0; b < block; b++)
+						l[s + b] = r[s + b] = 0.f;
+					for (int v = 0; v < N; v++) {
+						voice(v, y, block);
+						const float gl = left[v], gr = right[v];
+						for (int b = 0; b < block; b++) {
+							l[s + b] += y[b] * gl;
+							r[s + b] += y[b] * gr;
+						}
+					}
+				}
+			}
+
+		protected:
+			param detune = 0.f;
+
+			alignas(32) unsigned int phase[N] = { 0 };
+			alignas(32) unsigned int increment[N] = { 0 };
+			alignas(32) float cycles[N], rcp[N];				// increment (in cycles) and reciprocal
+			alignas(32) float duty[N], rise[N], fall[N];		// peak position and segment slopes
+			alignas(32) float integral[N] = { 0 };				// integral at previous sample
+			alignas(32) float left[N], right[N];				// stereo gains
+
+			// spread of a voice across the stack [-1, 1] (scales detune and pan)
+			static constexpr float spread(int voice) {
+				return N > 1 ? (2.f * voice) / (N - 1) - 1.f : 0.f;
+			}
+
+			// convert uint32 phase to float [0, 1) (exact, 24-bit)
+			static float fraction(unsigned int phase) {
+				return float(int(phase >> 8)) * (1.f / 16777216.f);
+			}
+
+			// integral of the (zero-mean) saw-triangle over [0, p) - periodic, continuous
+			float G(float p, int v) const {
+				const float a = p * p * rise[v] - p;
+				const float q = p - duty[v];
+				const float b = q - q * q * fall[v];
+				return p < duty[v] ? a : b;
+			}
+
+			// integral of the saw-triangle for a block of phases (see G)
+			static void integrate(unsigned int p, unsigned int inc, float d, float up, float down, float* g, int samples) {
+				int s = 0;
+#if defined(KLANG_AVX2)
+				__m256i i = _mm256_add_epi32(_mm256_set1_epi32(int(p)), _mm256_mullo_epi32(_mm256_set1_epi32(int(inc)), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+				const __m256i step = _mm256_set1_epi32(int(inc * 8u));
+				const __m256 scale = _mm256_set1_ps(1.f / 16777216.f), D = _mm256_set1_ps(d), UP = _mm256_set1_ps(up), DOWN = _mm256_set1_ps(down);
+				for (; s + 8 <= samples; s += 8) {
+					const __m256 x = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(i, 8)), scale);
+					const __m256 a = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(x, x), UP), x);
+					const __m256 q = _mm256_sub_ps(x, D);
+					const __m256 b = _mm256_sub_ps(q, _mm256_mul_ps(_mm256_mul_ps(q, q), DOWN));
+					_mm256_storeu_ps(g + s, _mm256_blendv_ps(b, a, _mm256_cmp_ps(x, D, _CMP_LT_OQ)));
+					i = _mm256_add_epi32(i, step);
+				}
+#elif defined(KLANG_SSE2)
+				__m128i i = _mm_setr_epi32(int(p), int(p + inc), int(p + 2 * inc), int(p + 3 * inc));
+				const __m128i step = _mm_set1_epi32(int(inc * 4u));
+				const __m128 scale = _mm_set1_ps(1.f / 16777216.f), D = _mm_set1_ps(d), UP = _mm_set1_ps(up), DOWN = _mm_set1_ps(down);
+				for (; s + 4 <= samples; s += 4) {
+					const __m128 x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(i, 8)), scale);
+					const __m128 a = _mm_sub_ps(_mm_mul_ps(_mm_mul_ps(x, x), UP), x);
+					const __m128 q = _mm_sub_ps(x, D);
+					const __m128 b = _mm_sub_ps(q, _mm_mul_ps(_mm_mul_ps(q, q), DOWN));
+					const __m128 rising = _mm_cmplt_ps(x, D);
+					_mm_storeu_ps(g + s, _mm_or_ps(_mm_and_ps(rising, a), _mm_andnot_ps(rising, b)));
+					i = _mm_add_epi32(i, step);
+				}
+#elif defined(KLANG_NEON)
+				const unsigned int init[4] = { p, p + inc, p + 2 * inc, p + 3 * inc };
+				uint32x4_t i = vld1q_u32(init);
+				const uint32x4_t step = vdupq_n_u32(inc * 4u);
+				const float32x4_t D = vdupq_n_f32(d), UP = vdupq_n_f32(up), DOWN = vdupq_n_f32(down);
+				for (; s + 4 <= samples; s += 4) {
+					const float32x4_t x = vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(i, 8)), 1.f / 16777216.f);
+					const float32x4_t a = vsubq_f32(vmulq_f32(vmulq_f32(x, x), UP), x);
+					const float32x4_t q = vsubq_f32(x, D);
+					const float32x4_t b = vsubq_f32(q, vmulq_f32(vmulq_f32(q, q), DOWN));
+					vst1q_f32(g + s, vbslq_f32(vcltq_f32(x, D), a, b));
+					i = vaddq_u32(i, step);
+				}
+#endif
+				for (; s < samples; s++) {
+					const float x = fraction(p + inc * (unsigned int)s);
+					const float a = x * x * up - x;
+					const float q = x - d;
+					const float b = q - q * q * down;
+					g[s] = x < d ? a : b;
+				}
+			}
+
+			void voice(int v, float* y, int samples) {
+				unsigned int p = phase[v];
+				const unsigned int inc = increment[v];
+
+				if constexpr (std::is_same<OSC, Fast::Sine>()) {
+					Fast::fastsin_block(p, inc, y, samples);
+				} else {
+					const float d = duty[v], up = rise[v], down = fall[v];
+					alignas(32) float g[BLOCK + 1];
+					g[0] = integral[v];
+					integrate(p, inc, d, up, down, g + 1, samples);
+					if (cycles[v] > 1.f / 4096.f) {	// average over the sample interval
+						const float k = rcp[v];
+						for (int s = 0; s < samples; s++)
+							y[s] = (g[s + 1] - g[s]) * k;
+					} else {						// (very low frequencies: no aliasing, avoid precision loss)
+						for (int s = 0; s < samples; s++) {
+							const float x = fraction(p + inc * (unsigned int)s);
+							const float rising = float(x < d);
+							y[s] = (2.f * x * up - 1.f) * rising + (1.f - 2.f * (x - d) * down) * (1.f - rising);
+						}
+					}
+					integral[v] = g[samples];
+				}
+				phase[v] = p + inc * (unsigned int)samples;
+			}
+		};
+
+		// additive oscillator bank (N sine partials, with per-partial frequency and amplitude ramps)
+		// - phases, increments, amplitudes and ramps are stored in contiguous, aligned arrays
+		// - each block is rendered 8 (AVX2) or 4 (SSE2/NEON) partials at a time
+		template<int N>
+		struct Additive : public Oscillator {
+			static constexpr int BLOCK = 64;				// samples rendered per pass
+			static constexpr int SIZE = (N + 7) & ~7;		// (padded with silent partials)
+
+			using Oscillator::set;
+			using Oscillator::process;
+
+			// starts with a saw spectrum (1/n), so set(f0) alone is audible
+			Additive() {
+				for (int p = 0; p < N; p++)
+					target[p] = 2.f / (pi * (p + 1));
+			}
+
+			void reset() override {
+				for (int p = 0; p < SIZE; p++)
+					phase[p] = 0;
+			}
+
+			// set all partials to a harmonic series (keeps amplitudes)
+			void set(param f0) override {
+				Oscillator::frequency = f0;
+				for (int p = 0; p < N; p++)
+					set(p, f0 * (p + 1), target[p]);
+			}
+
+			void set(param f0, param phase) override {
+				Fast::Phase i;
+				i = phase;
+				for (int p = 0; p < SIZE; p++)
+					Additive::phase[p] = i.position;
+				set(f0);
+			}
+
+			// set the frequency and amplitude of a partial (immediately)
+			void set(int partial, param frequency, param amplitude) {
+				ramp(partial, frequency, amplitude, 0.f);
+			}
+
+			// ramp the frequency and amplitude of a partial (linearly, over time in seconds)
+			void ramp(int partial, param frequency, param amplitude, param time) {
+				assert(partial >= 0 && partial < N);
+				const int length = (int)(time * fs);
+				Fast::Increment i;
+				i.set(frequency < fs * 0.5f ? (float)frequency : 0.f);
+				target[partial] = amplitude;
+				goal[partial] = (unsigned int)i.amount;
+				const float a = destination[partial] = frequency < fs * 0.5f ? (float)amplitude : 0.f; // (silence partials above nyquist)
+				if (length > 0) {
+					amplitudeStep[partial] = (a - level[partial]) / length;
+					incrementStep[partial] = (int)(((double)(int)goal[partial] - (double)(int)increment[partial]) / length);
+					remaining[partial] = length;
+				} else {
+					level[partial] = a;
+					increment[partial] = goal[partial];
+					amplitudeStep[partial] = 0;
+					incrementStep[partial] = 0;
+					remaining[partial] = 0;
+				}
+			}
+
+			// amplitude of a partial (target, if ramping)
+			float amplitude(int partial) const { return target[partial]; }
+
+			void process() override {
+				float y;
+				render(&y, 1);
+				out = y;
+			}
+
+			void process(signal* outputs, int samples) override {
+				for (int s = 0; s < samples; s += BLOCK)
+					render((float*)outputs + s, std::min(BLOCK, samples - s));
+				if (samples)
+					out = outputs[samples - 1];
+			}
+
+		protected:
+			alignas(32) unsigned int phase[SIZE] = { 0 };
+			alignas(32) unsigned int increment[SIZE] = { 0 };
+			alignas(32) int incrementStep[SIZE] = { 0 };
+			alignas(32) float level[SIZE] = { 0 };
+			alignas(32) float amplitudeStep[SIZE] = { 0 };
+			alignas(32) int remaining[SIZE] = { 0 };			// samples left in ramp
+			alignas(32) unsigned int goal[SIZE] = { 0 };		// ramp target (increment)
+			alignas(32) float destination[SIZE] = { 0 };		// ramp target (amplitude)
+			alignas(32) float target[SIZE] = { 0 };				// amplitude (as set)
+
+			void render(float* outputs, int samples) {
+				for (int s = 0; s < samples; s++)
+					outputs[s] = 0.f;
+
+				int p = 0;
+#if defined(KLANG_AVX2)
+				__m256 sum[BLOCK];	// (per-sample partial sums; reduced once per sample)
+				for (int s = 0; s < samples; s++)
+					sum[s] = _mm256_setzero_ps();
+				for (; p < SIZE; p += 8) {
+					__m256i ph = _mm256_load_si256((const __m256i*)(phase + p));
+					__m256i inc = _mm256_load_si256((const __m256i*)(increment + p));
+					__m256 amp = _mm256_load_ps(level + p);
+					const __m256i dinc = _mm256_load_si256((const __m256i*)(incrementStep + p));
+					const __m256 damp = _mm256_load_ps(amplitudeStep + p);
+					const __m256i left = _mm256_load_si256((const __m256i*)(remaining + p));
+					for (int s = 0; s < samples; s++) {
+						sum[s] = _mm256_add_ps(sum[s], _mm256_mul_ps(amp, Fast::fastsini(ph)));
+
+						ph = _mm256_add_epi32(ph, inc);
+						const __m256i ramping = _mm256_cmpgt_epi32(left, _mm256_set1_epi32(s));
+						inc = _mm256_add_epi32(inc, _mm256_and_si256(dinc, ramping));
+						amp = _mm256_add_ps(amp, _mm256_and_ps(damp, _mm256_castsi256_ps(ramping)));
+					}
+					_mm256_store_si256((__m256i*)(phase + p), ph);
+					_mm256_store_si256((__m256i*)(increment + p), inc);
+					_mm256_store_ps(level + p, amp);
+				}
+				for (int s = 0; s < samples; s++) {
+					__m128 h = _mm_add_ps(_mm256_castps256_ps128(sum[s]), _mm256_extractf128_ps(sum[s], 1));
+					h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+					outputs[s] = _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, 1)));
+				}
+#elif defined(KLANG_SSE2)
+				__m128 sum[BLOCK];	// (per-sample partial sums; reduced once per sample)
+				for (int s = 0; s < samples; s++)
+					sum[s] = _mm_setzero_ps();
+				for (; p < SIZE; p += 4) {
+					__m128i ph = _mm_load_si128((const __m128i*)(phase + p));
+					__m128i inc = _mm_load_si128((const __m128i*)(increment + p));
+					__m128 amp = _mm_load_ps(level + p);
+					const __m128i dinc = _mm_load_si128((const __m128i*)(incrementStep + p));
+					const __m128 damp = _mm_load_ps(amplitudeStep + p);
+					const __m128i left = _mm_load_si128((const __m128i*)(remaining + p));
+					for (int s = 0; s < samples; s++) {
+						sum[s] = _mm_add_ps(sum[s], _mm_mul_ps(amp, Fast::fastsini(ph)));
+
+						ph = _mm_add_epi32(ph, inc);
+						const __m128i ramping = _mm_cmpgt_epi32(left, _mm_set1_epi32(s));
+						inc = _mm_add_epi32(inc, _mm_and_si128(dinc, ramping));
+						amp = _mm_add_ps(amp, _mm_and_ps(damp, _mm_castsi128_ps(ramping)));
+					}
+					_mm_store_si128((__m128i*)(phase + p), ph);
+					_mm_store_si128((__m128i*)(increment + p), inc);
+					_mm_store_ps(level + p, amp);
+				}
+				for (int s = 0; s < samples; s++) {
+					__m128 h = _mm_add_ps(sum[s], _mm_movehl_ps(sum[s], sum[s]));
+					outputs[s] = _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, 1)));
+				}
+#elif defined(KLANG_NEON)
+				for (; p < SIZE; p += 4) {
+					uint32x4_t ph = vld1q_u32(phase + p);
+					uint32x4_t inc = vld1q_u32(increment + p);
+					float32x4_t amp = vld1q_f32(level + p);
+					const uint32x4_t dinc = vreinterpretq_u32_s32(vld1q_s32(incrementStep + p));
+					const float32x4_t damp = vld1q_f32(amplitudeStep + p);
+					const int32x4_t left = vld1q_s32(remaining + p);
+					for (int s = 0; s < samples; s++) {
+						outputs[s] += vaddvq_f32(vmulq_f32(amp, Fast::fastsini(ph)));
+
+						ph = vaddq_u32(ph, inc);
+						const uint32x4_t ramping = vcgtq_s32(left, vdupq_n_s32(s));
+						inc = vaddq_u32(inc, vandq_u32(dinc, ramping));
+						amp = vaddq_f32(amp, vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(damp), ramping)));
+					}
+					vst1q_u32(phase + p, ph);
+					vst1q_u32(increment + p, inc);
+					vst1q_f32(level + p, amp);
+				}
+#endif
+				for (; p < SIZE; p++) {
+					for (int s = 0; s < samples; s++) {
+						outputs[s] += level[p] * Fast::fastsini(phase[p]);
+						phase[p] += increment[p];
+						if (s < remaining[p]) {
+							increment[p] += incrementStep[p];
+							level[p] += amplitudeStep[p];
+						}
+					}
+				}
+
+				// advance ramps (landing exactly on their targets)
+				for (int p = 0; p < N; p++) {
+					if (remaining[p] > 0 && (remaining[p] -= samples) <= 0) {
+						remaining[p] = 0;
+						level[p] = destination[p];
+						increment[p] = goal[p];
+						amplitudeStep[p] = 0;
+						incrementStep[p] = 0;
+					}
+				}
+			}
+		};
+
+		template<int N> using OscillatorBank = Additive<N>;
+
+		namespace Wavetables {
+			struct Sine : public Wavetable {
+				Sine(int size = 2048) : Wavetable(Table::Sine, size) { }
+			};
+
+			struct Saw : public Wavetable {
+				Saw(int size = 2048) : Wavetable(Table::Saw, size) { }
+			};
+
+			struct Square : public Wavetable {
+				Square(int size = 2048) : Wavetable(Table::Square, size) { }
+			};
+
+			struct Triangle : public Wavetable {
+				Triangle(int size = 2048) : Wavetable(Table::Triangle, size) { }
+			};
+		}
+	};
+
+	namespace Oscillators {
+		// runtime-selectable oscillator (e.g. from a Menu control)
+		// - every shape is stored inline and constructed up front (no heap or locking when switching)
+		// - dispatches once per block (or sample) to the selected shape's non-virtual process()
+		// - switching shape carries over the current phase
+		template<typename... TYPES>
+		class Switchable : public Oscillator {
+			std::tuple<TYPES...> shapes;
+			int shape = 0;
+			unsigned int phase = 0;		// tracked phase (full range of uint32 = one cycle)
+			Fast::Increment delta;
+
+			template<int INDEX = 0, typename FUNCTION>
+			void apply(FUNCTION&& function) {
+				if constexpr (INDEX < (int)sizeof...(TYPES)) {
+					if (shape == INDEX)
+						function(std::get<INDEX>(shapes));
+					else
+						apply<INDEX + 1>(function);
+				}
+			}
+
+			// phase argument of TYPE::set(frequency, phase) for a uint32 phase
+			template<typename TYPE>
+			float argument(unsigned int phase) const {
+				if constexpr (std::is_base_of<Wavetable, TYPE>())
+					return (phase - (unsigned int)delta.amount) * (1.f / 4294967296.f);	// cycles (advanced before output)
+				else
+					return phase * (float(2 * pi) / 4294967296.f);				// radians
+			}
+
+		public:
+			using Oscillator::set;
+
+			// number of selectable shapes
+			static constexpr int size() { return (int)sizeof...(TYPES); }
+
+			// selected shape (index)
+			int selected() const { return shape; }
+
+			// select a shape by index (e.g. Menu control value)
+			void select(int index) {
+				assert(index >= 0 && index < size());
+				if (index == shape)
+					return;
+				shape = index;
+				apply([this](auto& osc) {
+					osc.set(frequency, argument<std::decay_t<decltype(osc)>>(phase));
+					static_cast<Oscillator&>(osc).set(+signal(offset * (1.f / (2 * pi))));	// (also clears a stale offset)
+				});
+			}
+
+			// select a shape by type
+			template<typename TYPE, int INDEX = 0>
+			void select() {
+				static_assert(INDEX < (int)sizeof...(TYPES), "shape not in oscillator");
+				if constexpr (std::is_same<TYPE, std::tuple_element_t<INDEX, std::tuple<TYPES...>>>())
+					select(INDEX);
+				else
+					select<TYPE, INDEX + 1>();
+			}
+
+			void reset() override {
+				phase = 0;
+				apply([this](auto& osc) { osc.set(frequency, 0.f); });
+			}
+
+			void set(param frequency) override {
+				Oscillator::frequency = frequency;
+				delta.set(frequency);
+				apply([&](auto& osc) { osc.set(frequency); });
+			}
+
+			void set(param frequency, param phase) override {
+				Oscillator::frequency = frequency;
+				delta.set(frequency);
+				Fast::Phase p;
+				p = phase;
+				Switchable::phase = p.position;
+				apply([&](auto& osc) { osc.set(frequency, argument<std::decay_t<decltype(osc)>>(Switchable::phase)); });
+			}
+
+			void set(relative phase) override {
+				offset = phase * (2 * pi);
+				apply([&](auto& osc) { static_cast<Oscillator&>(osc).set(phase); }); // (via the base, as set(param) overloads may hide set(relative))
+			}
+
+			void set(param frequency, relative phase) override {
+				set(frequency);
+				set(phase);
+			}
+
+			void process() override {
+				apply([this](auto& osc) { osc.process(); out = osc.out; });
+				phase += (unsigned int)delta.amount;
+			}
+
+			void process(signal* outputs, int samples) override {
+				apply([&](auto& osc) { osc.process(outputs, samples); });
+				phase += (unsigned int)delta.amount * (unsigned int)samples;
+				if (samples)
+					out = outputs[samples - 1];
+			}
+		};
+	};
+
+	// runtime-selectable oscillator (sine, saw, square or triangle)
+	typedef Oscillators::Switchable<Oscillators::Fast::Sine, Oscillators::Fast::Saw, Oscillators::Wavetables::Square, Oscillators::Wavetables::Triangle> Osc;
+
+	namespace Filters {
+		namespace Basic {
+			struct LPF : public Modifier {
+				float a, b;
+
+				void set(param coeff) {
+					a = coeff;
+					b = 1 - a;
+				}
+
+				void process() {
+					out = (a * in) + (b * out);
+				}
+
+				void process(const signal* inputs, signal* outputs, int samples) override {
+					float x = in, y = out;
+					for (int s = 0; s < samples; s++) {
+						x = inputs[s];
+						outputs[s] = y = (a * x) + (b * y);
+					}
+					in = x;
+					out = y;
+				}
+			};
+
+			struct HPF : public LPF {
+				void process() {
+					out = (a * in) - (b * out);
+				}
 
-		void attach(SYNTH* synth) {
-			NoteBase::synth = synth;
-			controls = synth->controls;
-			init();
+				void process(const signal* inputs, signal* outputs, int samples) override {
+					float x = in, y = out;
+					for (int s = 0; s < samples; s++) {
+						x = inputs[s];
+						outputs[s] = y = (a * x) - (b * y);
+					}
+					in = x;
+					out = y;
+				}
+			};
 		}
 
-		virtual void init() { }
+		// coefficient update policy (e.g. for filters set every sample: in >> lpf(mod) >> out)
+		struct Policy {
+			float tolerance = 0.f;	// redesign only when a parameter moves by more than this (relative; 0 = any change)
+			int rate = 1;			// redesign at most every [rate] samples, interpolating the coefficients in between
+			bool table = false;		// design from the cutoff lookup table (fast path), rather than trig functions
+		};
 
-		virtual void start(Pitch p, Velocity v) {
-			stage = Onset;
-			pitch = p;
-			velocity = v;
-			on(pitch, velocity);
-			stage = Sustain;
-		}
+		// trigonometric terms of a cutoff frequency (w = 2 pi f / fs)
+		struct Cutoff {
+			float cosw, sinw, g;	// cos(w), sin(w), tan(w / 2)
 
-		virtual bool release(Velocity v = 0) {
-			if (stage == Off)
-				return true;
+			static constexpr int SIZE = 4096;	// table intervals over [0, nyquist]
+			static constexpr double MAX = 0.49;	// highest cutoff (fraction of fs)
 
-			if (stage != Release) {
-				stage = Release;
-				off(v);
+			static Cutoff exact(double frequency) {
+				const double x = std::min(std::max(frequency / fs, 0.0), MAX);
+				const double w = 2.0 * 3.1415926535897932384626433832795 * x;
+				return { (float)cos(w), (float)sin(w), (float)tan(w / 2) };
 			}
-			
-			return stage == Off;
-		}
-
-		virtual bool stop(Velocity v = 0) {
-			stage = Off;
-			return true;
-		}
 
-		bool finished() const { return stage == Off; }
+			// table lookup (linear interpolation; ~1e-7 error for cos/sin, ~1e-4 relative for tan near nyquist)
+			static Cutoff lookup(float frequency);
 
-		enum Stage { Onset, Sustain, Release, Off } stage = Off;
+			static Cutoff get(float frequency, bool table) {
+				return table ? lookup(frequency) : exact(frequency);
+			}
 
-		virtual void controlChange(int controller, int value) { control(controller, value); };
-	};
+			static const std::vector<Cutoff> TABLE;	// (built at static initialisation, never on the audio thread)
+		};
 
-	struct Synth;
+		inline const std::vector<Cutoff> Cutoff::TABLE = [] {
+			std::vector<Cutoff> table(SIZE + 1);
+			for (int i = 0; i <= SIZE; i++) {
+				const double w = 3.1415926535897932384626433832795 * i / SIZE;
+				table[i] = { (float)cos(w), (float)sin(w), (float)tan(w / 2) };	// (the last entry is never interpolated)
+			}
+			return table;
+		}();
+
+		inline Cutoff Cutoff::lookup(float frequency) {
+			const float x = std::min(std::max(frequency / fs, 0.f), (float)MAX) * (2.f * SIZE);
+			const int i = (int)x;
+			const float f = x - (float)i;
+			const Cutoff& a = TABLE[i];
+			const Cutoff& b = TABLE[i + 1];
+			return { a.cosw + (b.cosw - a.cosw) * f, a.sinw + (b.sinw - a.sinw) * f, a.g + (b.g - a.g) * f };
+		}
+
+		// filter coefficients under a Policy (COEFFICIENTS: struct of floats; designed from up to 3 parameters)
+		// - the filter calls request() from set(), due() once per sample, and apply() with the new design
+		template<typename COEFFICIENTS>
+		struct Update {
+			static_assert(sizeof(COEFFICIENTS) % sizeof(float) == 0, "coefficients must be floats");
+			static constexpr int SIZE = sizeof(COEFFICIENTS) / sizeof(float);
+
+			Policy policy;
+			alignas(16) COEFFICIENTS c;		// current coefficients
+			float target[3] = { 0, 0, 0 };	// requested parameters
+			float designed[3] = { -1, -1, -1 };	// parameters of the last design
+
+			// request new parameters (returns true if a redesign is due now)
+			bool request(float p0, float p1 = 0, float p2 = 0) {
+				target[0] = p0; target[1] = p1; target[2] = p2;
+				return policy.rate <= 1 && moved();
+			}
 
-	// base class for individual synthesiser notes/voices
-	struct Note : public NoteBase<Synth>, public Generator {
-		virtual void prepare() { }
-		virtual void process() override = 0;
-		virtual bool process(buffer buffer) {
-			prepare();
-			while (buffer) {
-				process();
-				buffer++ = out;
-				debug++;
+			// advance one sample (returns true if a redesign is due; control rate only)
+			bool due() {
+				if (ramp) {
+					float* x = (float*)&c;
+					const float* dx = (const float*)&step;
+					if (--ramp)
+						for (int i = 0; i < SIZE; i++) x[i] += dx[i];
+					else
+						c = goal;
+				}
+				if (policy.rate <= 1 || --countdown > 0)
+					return false;
+				countdown = policy.rate;
+				return moved();
 			}
-			return !finished();
-		}
-		virtual bool process(buffer* buffer) {
-			return process(buffer[0]);
-		}
-	};
 
-	template<class SYNTH, class NOTE = Note>
-	struct Notes : Array<NOTE*, 128> {
-		SYNTH* synth;
-		typedef Array<NOTE*, 128> Array;
-		using Array::items;
-		using Array::count;
+			// apply a new design (immediately, or interpolated over the control period)
+			void apply(const COEFFICIENTS& next) {
+				for (int i = 0; i < 3; i++)
+					designed[i] = target[i];
+				if (policy.rate <= 1 || first) {
+					c = goal = next;
+					ramp = 0;
+				} else {
+					goal = next;
+					ramp = policy.rate;
+					const float* x = (const float*)&c;
+					const float* y = (const float*)&next;
+					float* dx = (float*)&step;
+					for (int i = 0; i < SIZE; i++)
+						dx[i] = (y[i] - x[i]) / policy.rate;
+				}
+				first = false;
+			}
 
-		Notes(SYNTH* synth) : synth(synth) {
-			for (int n = 0; n < 128; n++)
-				items[n] = nullptr;
-		}
-		virtual ~Notes();
+			// true if the coefficients may change per sample (i.e. block processing must tick)
+			bool active() const { return policy.rate > 1; }
 
-		template<class TYPE>
-		void add(int count) {
-			for (int n = 0; n < count; n++) {
-				TYPE* note = new TYPE();
-				note->attach(synth);
-				Array::add(note);
+		protected:
+			bool moved() const {
+				for (int i = 0; i < 3; i++) {
+					const float d = fabsf(target[i] - designed[i]);
+					if (d > policy.tolerance * std::max(fabsf(designed[i]), 1.f))
+						return true;
+				}
+				return false;
 			}
-		}
 
-		// returns index of a 'free' note (stealing oldest, if required)
-		unsigned int noteOns = 0;				// number of NoteOn events processed
-		unsigned int noteStart[128] = { 0 };	// track age of notes (for note stealing)
+			COEFFICIENTS step, goal;
+			int ramp = 0, countdown = 0;
+			bool first = true;
+		};
 
-		int assign(){
-			// favour unused voices
-			for (int i = 0; i < count; i++) {
-				if (items[i]->stage == NOTE::Off){
-					noteStart[i] = noteOns++;
-					return i;
+		// biquad filters (RBJ cookbook coefficients; transposed direct form II)
+		namespace Biquad {
+			enum Mode { LowPass, HighPass, BandPass, Notch, AllPass, Peak, LowShelf, HighShelf };
+
+			// normalised coefficients (a0 = 1)
+			struct Coefficients {
+				float b0 = 1, b1 = 0, b2 = 0, a1 = 0, a2 = 0;
+
+				// design a filter (frequency in Hz, Q, gain in dB for Peak/LowShelf/HighShelf)
+				static Coefficients design(Mode mode, float frequency, float Q = 0.70710678f, float gain = 0.f, bool table = false) {
+					return design(mode, Cutoff::get(std::max(frequency, 1.f), table), Q, gain);
 				}
-			}
 
-			// no free notes => steal oldest released note?
-			int oldest = -1;
-			unsigned int oldest_start = 0;
-			for (int i = 0; i < count; i++) {
-				if (items[i]->stage == NOTE::Release) {
-					if(oldest == -1 || noteStart[i] < oldest_start){
-						oldest = i;
-						oldest_start = noteStart[i];
+				static Coefficients design(Mode mode, const Cutoff& cutoff, float Q = 0.70710678f, float gain = 0.f) {
+					const double cosw = cutoff.cosw;
+					const double alpha = cutoff.sinw / (2.0 * std::max((double)Q, 0.01));
+					const double A = (mode >= Peak) ? pow(10.0, gain / 40.0) : 1.0, sqrtA2alpha = 2.0 * sqrt(A) * alpha;
+
+					double b0, b1, b2, a0, a1, a2;
+					switch (mode) {
+					case LowPass:	b0 = (1 - cosw) / 2;	b1 = 1 - cosw;		b2 = b0;		a0 = 1 + alpha;		a1 = -2 * cosw;		a2 = 1 - alpha;		break;
+					case HighPass:	b0 = (1 + cosw) / 2;	b1 = -(1 + cosw);	b2 = b0;		a0 = 1 + alpha;		a1 = -2 * cosw;		a2 = 1 - alpha;		break;
+					case BandPass:	b0 = alpha;				b1 = 0;				b2 = -alpha;	a0 = 1 + alpha;		a1 = -2 * cosw;		a2 = 1 - alpha;		break;
+					case Notch:		b0 = 1;					b1 = -2 * cosw;		b2 = 1;			a0 = 1 + alpha;		a1 = -2 * cosw;		a2 = 1 - alpha;		break;
+					case AllPass:	b0 = 1 - alpha;			b1 = -2 * cosw;		b2 = 1 + alpha;	a0 = 1 + alpha;		a1 = -2 * cosw;		a2 = 1 - alpha;		break;
+					case Peak:		b0 = 1 + alpha * A;		b1 = -2 * cosw;		b2 = 1 - alpha * A;	a0 = 1 + alpha / A;	a1 = -2 * cosw;	a2 = 1 - alpha / A;	break;
+					case LowShelf:
+						b0 = A * ((A + 1) - (A - 1) * cosw + sqrtA2alpha);
+						b1 = 2 * A * ((A - 1) - (A + 1) * cosw);
+						b2 = A * ((A + 1) - (A - 1) * cosw - sqrtA2alpha);
+						a0 = (A + 1) + (A - 1) * cosw + sqrtA2alpha;
+						a1 = -2 * ((A - 1) + (A + 1) * cosw);
+						a2 = (A + 1) + (A - 1) * cosw - sqrtA2alpha;
+						break;
+					case HighShelf:
+						b0 = A * ((A + 1) + (A - 1) * cosw + sqrtA2alpha);
+						b1 = -2 * A * ((A - 1) + (A + 1) * cosw);
+						b2 = A * ((A + 1) + (A - 1) * cosw - sqrtA2alpha);
+						a0 = (A + 1) - (A - 1) * cosw + sqrtA2alpha;
+						a1 = 2 * ((A - 1) - (A + 1) * cosw);
+						a2 = (A + 1) - (A - 1) * cosw - sqrtA2alpha;
+						break;
+					default:
+						return Coefficients();
 					}
+
+					Coefficients c;
+					c.b0 = float(b0 / a0); c.b1 = float(b1 / a0); c.b2 = float(b2 / a0);
+					c.a1 = float(a1 / a0); c.a2 = float(a2 / a0);
+					return c;
 				}
-			}
-			if(oldest != -1){
-				noteStart[oldest] = noteOns++;
-				return oldest;
-			}
+			};
 
-			// no available released notes => steal oldest playing note
-			oldest = -1;
-			oldest_start = 0;
-			for (int i = 0; i < count; i++) {
-				if(oldest == -1 || noteStart[i] < oldest_start){
-					oldest = i;
-					oldest_start = noteStart[i];
+			// biquad filter (mode selectable at runtime)
+			struct Filter : public Modifier {
+				Filter(Mode mode = LowPass) : mode(mode) {
+					update.target[1] = 0.70710678f;
 				}
-			}
-			noteStart[oldest] = noteOns++;
-			return oldest;
-		}
-	};
 
-	// base class for synthesiser mini-plugins
-	struct Synth : public Effect {
-		typedef Note Note;
+				void setMode(Mode mode) {
+					Filter::mode = mode;
+					update.apply(design());
+				}
 
-		Notes<Synth, Note> notes;
+				// set the coefficient update policy (e.g. for audio-rate modulation)
+				void setPolicy(const Policy& policy) {
+					update.policy = policy;
+				}
 
-		Synth() : notes(this) { }
-		virtual ~Synth() { }
+				void set(param frequency) override {					set(frequency, update.target[1], update.target[2]);	}
+				void set(param frequency, param Q) override {			set(frequency, Q, update.target[2]);	}
+				void set(param frequency, param Q, param gain) override {		// (gain in dB)
+					if (update.request(frequency, Q, gain))
+						update.apply(design());
+				}
 
-		virtual void presetLoaded(int preset) { }
-		virtual void optionChanged(int param, int item) { }
-		virtual void buttonPressed(int param) { };
+				void reset() {
+					z1 = z2 = 0;
+				}
 
-		int indexOf(Note* note) const {
-			int index = 0;
-			for (const auto* n : notes.items) {
-				if (note == n) return 
-					index;
-				index++;
-			}
-			return -1; // not found
-		}
-	};
+				void process() {
+					if (update.due())
+						update.apply(design());
+					const Coefficients& c = update.c;
+					const float x = in;
+					out = c.b0 * x + z1;
+					z1 = c.b1 * x - c.a1 * out + z2;
+					z2 = c.b2 * x - c.a2 * out;
+				}
 
-	template<class SYNTH, class NOTE>
-	inline Notes<SYNTH, NOTE>::~Notes() {
-		for (unsigned int n = 0; n < count; n++) {
-			NOTE* tmp = items[n];
-			items[n] = nullptr;
-			delete tmp;
-		}
-	}
+				void process(const signal* inputs, signal* outputs, int samples) override {
+					if (update.active()) { // (coefficients may change per sample: tick inline)
+						for (int s = 0; s < samples; s++) {
+							in = inputs[s];
+							Filter::process();
+							outputs[s] = out;
+						}
+						return;
+					}
 
-	namespace Mono { using namespace klang; }
-	namespace mono { using namespace klang; }
+					const Coefficients c = update.c;
+					float s1 = z1, s2 = z2, x = in, y = out;
+					for (int s = 0; s < samples; s++) {
+						x = inputs[s];
+						y = c.b0 * x + s1;
+						s1 = c.b1 * x - c.a1 * y + s2;
+						s2 = c.b2 * x - c.a2 * y;
+						outputs[s] = y;
+					}
+					z1 = s1; z2 = s2;
+					in = x; out = y;
+				}
 
-	namespace Stereo {
-		typedef signals<2> signal;
+			protected:
+				Coefficients design() const {
+					return Coefficients::design(mode, update.target[0], update.target[1], update.target[2], update.policy.table);
+				}
 
-		struct frame {
-			mono::signal& l;
-			mono::signal& r;
+				Mode mode;
+				Update<Coefficients> update;
+				float z1 = 0, z2 = 0;
+			};
 
-			frame(mono::signal& left, mono::signal& right) : l(left), r(right) { }
-			frame(signal& signal) : l(signal.l), r(signal.r) { }
+			struct LPF : public Filter { LPF() : Filter(LowPass) { } };
+			struct HPF : public Filter { HPF() : Filter(HighPass) { } };
+			struct BPF : public Filter { BPF() : Filter(BandPass) { } };
+			struct BSF : public Filter { BSF() : Filter(Notch) { } };
+			struct APF : public Filter { APF() : Filter(AllPass) { } };
+			struct PEQ : public Filter { PEQ() : Filter(Peak) { } };
+			struct LSF : public Filter { LSF() : Filter(LowShelf) { } };
+			struct HSF : public Filter { HSF() : Filter(HighShelf) { } };
+		}
 
-			frame& operator+=(const frame& x) { l += x.l; r += x.r; return *this; }
-			frame& operator-=(const frame& x) { l -= x.l; r -= x.r; return *this; }
-			frame& operator*=(const frame& x) { l *= x.l; r *= x.r; return *this; }
-			frame& operator/=(const frame& x) { l /= x.l; r /= x.r; return *this; }
+		// state-variable filter (topology-preserving transform; stable under fast modulation)
+		// - all responses share the same state; mode selects the output mix (m0 * in + m1 * band + m2 * low)
+		struct SVF : public Modifier {
+			enum Mode { LowPass, BandPass, HighPass, Notch, Peak, AllPass };
 
-			frame& operator+=(const signal x) { l += x.l; r += x.r; return *this; }
-			frame& operator-=(const signal x) { l -= x.l; r -= x.r; return *this; }
-			frame& operator*=(const signal x) { l *= x.l; r *= x.r; return *this; }
-			frame& operator/=(const signal x) { l /= x.l; r /= x.r; return *this; }
+			// coefficients (a1..a3: integrators; m0..m2: output mix)
+			struct Coefficients {
+				float a1 = 1, a2 = 0, a3 = 0, m0 = 0, m1 = 0, m2 = 1;
 
-			frame& operator+=(const mono::signal x) { l += x; r += x; return *this; }
-			frame& operator-=(const mono::signal x) { l -= x; r -= x; return *this; }
-			frame& operator*=(const mono::signal x) { l *= x; r *= x; return *this; }
-			frame& operator/=(const mono::signal x) { l /= x; r /= x; return *this; }
+				// design a filter (frequency in Hz, Q)
+				static Coefficients design(Mode mode, float frequency, float Q = 0.70710678f, bool table = false) {
+					return design(mode, Cutoff::get(std::max(frequency, 1.f), table), Q);
+				}
 
-			frame& operator+=(float x) { l += x; r += x; return *this; }
-			frame& operator-=(float x) { l -= x; r -= x; return *this; }
-			frame& operator*=(float x) { l *= x; r *= x; return *this; }
-			frame& operator/=(float x) { l /= x; r /= x; return *this; }
+				static Coefficients design(Mode mode, const Cutoff& cutoff, float Q = 0.70710678f) {
+					const double g = cutoff.g;
+					const double k = 1.0 / std::max((double)Q, 0.01);
+					Coefficients c;
+					c.a1 = float(1.0 / (1.0 + g * (g + k)));
+					c.a2 = float(g * c.a1);
+					c.a3 = float(g * c.a2);
+					switch (mode) {
+					case LowPass:	c.m0 = 0;	c.m1 = 0;				c.m2 = 1;	break;
+					case BandPass:	c.m0 = 0;	c.m1 = 1;				c.m2 = 0;	break;
+					case HighPass:	c.m0 = 1;	c.m1 = float(-k);		c.m2 = -1;	break;
+					case Notch:		c.m0 = 1;	c.m1 = float(-k);		c.m2 = 0;	break;
+					case Peak:		c.m0 = 1;	c.m1 = float(-k);		c.m2 = -2;	break;
+					case AllPass:	c.m0 = 1;	c.m1 = float(-2 * k);	c.m2 = 0;	break;
+					}
+					return c;
+				}
+			};
 
-			frame& operator+=(double x) { l += (float)x; r += (float)x; return *this; }
-			frame& operator-=(double x) { l -= (float)x; r -= (float)x; return *this; }
-			frame& operator*=(double x) { l *= (float)x; r *= (float)x; return *this; }
-			frame& operator/=(double x) { l /= (float)x; r /= (float)x; return *this; }
+			SVF(Mode mode = LowPass) : mode(mode) {
+				update.target[1] = 0.70710678f;
+			}
 
-			frame& operator+=(int x) { l += (float)x; r += (float)x; return *this; }
-			frame& operator-=(int x) { l -= (float)x; r -= (float)x; return *this; }
-			frame& operator*=(int x) { l *= (float)x; r *= (float)x; return *this; }
-			frame& operator/=(int x) { l /= (float)x; r /= (float)x; return *this; }
+			void setMode(Mode mode) {
+				SVF::mode = mode;
+				update.apply(design());
+			}
 
-			signal operator+(const signal x) const { return { l + x.l, r + x.r }; }
-			signal operator-(const signal x) const { return { l - x.l, r - x.r }; }
-			signal operator*(const signal x) const { return { l * x.l, r * x.r }; }
-			signal operator/(const signal x) const { return { l / x.l, r / x.r }; }
+			// set the coefficient update policy (e.g. for audio-rate modulation)
+			void setPolicy(const Policy& policy) {
+				update.policy = policy;
+			}
 
-			signal operator+(const mono::signal x) const { return { l + x, r + x }; }
-			signal operator-(const mono::signal x) const { return { l - x, r - x }; }
-			signal operator*(const mono::signal x) const { return { l * x, r * x }; }
-			signal operator/(const mono::signal x) const { return { l / x, r / x }; }
+			void set(param frequency) override {					set(frequency, update.target[1]);	}
+			void set(param frequency, param Q) override {
+				if (update.request(frequency, Q))
+					update.apply(design());
+			}
 
-			signal operator+(float x) const { return { l + x, r + x }; }
-			signal operator-(float x) const { return { l - x, r - x }; }
-			signal operator*(float x) const { return { l * x, r * x }; }
-			signal operator/(float x) const { return { l / x, r / x }; }
+			void reset() {
+				ic1 = ic2 = 0;
+			}
 
-			signal operator+(double x) const { return { l + (float)x, r + (float)x }; }
-			signal operator-(double x) const { return { l - (float)x, r - (float)x }; }
-			signal operator*(double x) const { return { l * (float)x, r * (float)x }; }
-			signal operator/(double x) const { return { l / (float)x, r / (float)x }; }
+			void process() {
+				if (update.due())
+					update.apply(design());
+				const Coefficients& c = update.c;
+				const float v0 = in;
+				const float v3 = v0 - ic2;
+				const float v1 = c.a1 * ic1 + c.a2 * v3;
+				const float v2 = ic2 + c.a2 * ic1 + c.a3 * v3;
+				ic1 = 2 * v1 - ic1;
+				ic2 = 2 * v2 - ic2;
+				out = c.m0 * v0 + c.m1 * v1 + c.m2 * v2;
+			}
 
-			signal operator+(int x) const { return { l + (float)x, r + (float)x }; }
-			signal operator-(int x) const { return { l - (float)x, r - (float)x }; }
-			signal operator*(int x) const { return { l * (float)x, r * (float)x }; }
-			signal operator/(int x) const { return { l / (float)x, r / (float)x }; }
+			void process(const signal* inputs, signal* outputs, int samples) override {
+				if (update.active()) { // (coefficients may change per sample: tick inline)
+					for (int s = 0; s < samples; s++) {
+						in = inputs[s];
+						SVF::process();
+						outputs[s] = out;
+					}
+					return;
+				}
 
-			frame& operator=(const signal& signal) {
-				l = signal.l;
-				r = signal.r;
-				return *this;
+				const Coefficients c = update.c;
+				float s1 = ic1, s2 = ic2, v0 = in, y = out;
+				for (int s = 0; s < samples; s++) {
+					v0 = inputs[s];
+					const float v3 = v0 - s2;
+					const float v1 = c.a1 * s1 + c.a2 * v3;
+					const float v2 = s2 + c.a2 * s1 + c.a3 * v3;
+					s1 = 2 * v1 - s1;
+					s2 = 2 * v2 - s2;
+					outputs[s] = y = c.m0 * v0 + c.m1 * v1 + c.m2 * v2;
+				}
+				ic1 = s1; ic2 = s2;
+				in = v0; out = y;
 			}
 
-			mono::signal mono() const {
-				return (l + r) * 0.5f;
+		protected:
+			Coefficients design() const {
+				return Coefficients::design(mode, update.target[0], update.target[1], update.policy.table);
 			}
+
+			Mode mode;
+			Update<Coefficients> update;
+			float ic1 = 0, ic2 = 0;
 		};
 
-		struct Input : Generic::Input<signal> { };
-		struct Output : Generic::Output<signal> { };
-		struct Generator : Generic::Generator<signal> { };
-		struct Modifier : Generic::Modifier<signal> { };
-		struct Oscillator : Generic::Oscillator<signal> { };
+		// 4-pole (24dB/oct) ladder low-pass filter (zero-delay feedback; resonance [0, 1] self-oscillates at 1)
+		struct Ladder : public Modifier {
+			// coefficients (G: one-pole gain; k: feedback; feedback: loop normalisation)
+			struct Coefficients {
+				float G = 0, k = 0, feedback = 1;
+
+				static Coefficients design(float frequency, float resonance, bool table = false) {
+					const double g = Cutoff::get(std::max(frequency, 1.f), table).g;
+					Coefficients c;
+					c.G = float(g / (1.0 + g));
+					c.k = 4.f * std::min(std::max(resonance, 0.f), 1.f);
+					c.feedback = 1.f / (1.f + c.k * c.G * c.G * c.G * c.G);
+					return c;
+				}
+			};
+
+			// set the coefficient update policy (e.g. for audio-rate modulation)
+			void setPolicy(const Policy& policy) {
+				update.policy = policy;
+			}
+
+			void set(param frequency) override {					set(frequency, update.target[1]);	}
+			void set(param frequency, param resonance) override {
+				if (update.request(frequency, resonance))
+					update.apply(design());
+			}
 
+			void reset() {
+				for (int i = 0; i < 4; i++)
+					z[i] = 0;
+			}
+
+			void process() {
+				if (update.due())
+					update.apply(design());
+				out = tick(in, update.c);
+			}
+
+			void process(const signal* inputs, signal* outputs, int samples) override {
+				if (update.active()) { // (coefficients may change per sample: tick inline)
+					for (int s = 0; s < samples; s++) {
+						in = inputs[s];
+						Ladder::process();
+						outputs[s] = out;
+					}
+					return;
+				}
+
+				const Coefficients c = update.c;
+				for (int s = 0; s < samples; s++)
+					outputs[s] = tick(inputs[s], c);
+				if (samples) {
+					in = inputs[samples - 1];
+					out = outputs[samples - 1];
+				}
+			}
 
+		protected:
+			Coefficients design() const {
+				return Coefficients::design(update.target[0], update.target[1], update.policy.table);
+			}
 
-		inline Modifier& operator>>(signal input, Modifier& modifier) {
-			modifier << input;
-			return modifier;
-		}
+			float tick(float x, const Coefficients& c) {
+				// solve the feedback loop (each stage: y = G * x + (1 - G) * z)
+				const float G = c.G, b = 1.f - G;
+				const float S = b * (G * (G * (G * z[0] + z[1]) + z[2]) + z[3]);
+				float u = (x - c.k * S) * c.feedback;
+				for (int i = 0; i < 4; i++) {
+					const float v = G * (u - z[i]);
+					u = v + z[i];
+					z[i] = u + v;
+				}
+				return u;
+			}
 
-		// interleaved access to non-interleaved stereo buffers
-		struct buffer {
-			mono::buffer& left, right;
+			Update<Coefficients> update;
+			float z[4] = { 0 };
+		};
+	}
 
-			buffer(const buffer& buffer) : left(buffer.left), right(buffer.right) { rewind(); }
-			buffer(mono::buffer& left, mono::buffer& right) : left(left), right(right) { rewind(); }
+	// static-dispatch (CRTP) versions of the stock components
+	namespace Static {
+		// fast sine oscillator (see Oscillators::Fast::Sine; keeps its phase in fixed-point only)
+		struct Sine : public Generator<Sine> {
+			using Generator<Sine>::process;
 
-			operator const signal() const { return { left, right }; }
-			operator frame () {				return { left, right }; }
-			operator bool() const {			return left.operator bool() && right.operator bool(); }
-			frame operator++(int) {			return { left++, right++ };	}
+			Frequency frequency = 1000.f;	// fundamental frequency of oscillator (in Hz)
 
-			frame operator=(const signal& in) {
-				return { left = in.l, right = in.r };
+			void reset() {
+				position = klang::Oscillators::accumulator();
+				offset = 0;
+				set(frequency, 0.f);
 			}
 
-			buffer& operator=(const buffer& in) {
-				left = in.left;
-				right = in.right;
-				return *this;
+			void set(param frequency) {
+				if (frequency != Sine::frequency) {
+					Sine::frequency = frequency;
+					increment = klang::Oscillators::accumulator::frequency(frequency);
+				}
 			}
 
-			buffer& operator+=(const signal& in) {
-				left += in.l;
-				right += in.r;
-				return *this;
+			void set(param frequency, param phase) {
+				klang::Oscillators::Fast::Phase p;
+				p = phase; // (as Fast::Phase)
+				position = klang::Oscillators::accumulator::fixed(p.position);
+				offset = 0;
+				set(frequency);
 			}
 
-			buffer& operator=(const frame& in) { 		left = in.l;  right = in.r;		return *this;	}
-			buffer& operator+=(const frame& in) {		left += in.l; right += in.r;	return *this;	}
-			buffer& operator*=(const frame& in) {		left *= in.l; right *= in.r;	return *this;	}
-
-			buffer& operator=(const mono::signal in) {		left = in;  right = in;	return *this;	}
-			buffer& operator+=(const mono::signal in) {	left += in; right += in;return *this;	}
-			buffer& operator*=(const mono::signal in) {	left *= in; right *= in;return *this;	}
-
-			frame operator[](int index) {
-				return { left[index], right[index] };
+			void set(param frequency, relative phase) {
+				set(frequency);
+				set(phase);
 			}
 
-			mono::buffer& channel(int index) {
-				return index == 1 ? right : left;
+			void set(relative phase) {
+				offset = phase * klang::Oscillators::Fast::twoPi;
 			}
 
-			void clear() {
-				left.clear();
-				right.clear();
+			void process() {
+				out = klang::Oscillators::Fast::fastsini(position.top() + offset.position);
+				position += increment;
 			}
 
-			void clear(int size) {
-				left.clear(size);
-				right.clear(size);
+			void process(signal* outputs, int samples) {
+				klang::Oscillators::Fast::fastsin_block(position, increment, offset.position, (float*)outputs, samples);
+				position += increment * (unsigned int)samples;
+				if (samples)
+					out = outputs[samples - 1];
 			}
 
-			void rewind() {
-				left.rewind();
-				right.rewind();
+		protected:
+			klang::Oscillators::accumulator position, increment;
+			klang::Oscillators::Fast::Phase offset;
+		};
+
+		// anti-aliased saw/triangle oscillator (see Oscillators::Fast::Saw)
+		struct Saw : public Oscillator<Saw> {
+			using Oscillator<Saw>::process;
+
+			void set(param frequency) {							osm.set(frequency);					}
+			void set(param frequency, param phase) {				osm.set(frequency, phase);			}
+			void set(param frequency, param phase, param duty) {	osm.set(frequency, phase, duty);	}
+
+			void process() {
+				out = osm.output();
 			}
+
+		protected:
+			klang::Oscillators::Fast::OSM osm;
 		};
 
-		struct Effect : public Plugin, public Modifier {
-			virtual ~Effect() { }
+		// one-pole low-pass filter (see Filters::Basic::LPF)
+		struct LPF : public Modifier<LPF> {
+			float a, b;
 
-			virtual void prepare() { };
-			virtual void process() { out = in; };
-			virtual void process(Stereo::buffer buffer) {
-				prepare();
-				while (buffer) {
-					input(buffer);
-					process();
-					buffer++ = out;
-					debug++;
+			void set(param coeff) {
+				a = coeff;
+				b = 1 - a;
+			}
+
+			void process() {
+				out = (a * in) + (b * out);
+			}
+
+			void process(const signal* inputs, signal* outputs, int samples) {
+				float x = in, y = out;
+				for (int s = 0; s < samples; s++) {
+					x = inputs[s];
+					outputs[s] = y = (a * x) + (b * y);
 				}
+				in = x;
+				out = y;
 			}
 		};
 
-		struct Synth;
+		// one-pole high-pass filter (see Filters::Basic::HPF)
+		struct HPF : public Modifier<HPF> {
+			float a, b;
 
-		// stereo note object
-		struct Note : public NoteBase<Synth>, public Generator { 
-			//virtual signal output() { return 0; };
+			void set(param coeff) {
+				a = coeff;
+				b = 1 - a;
+			}
 
-			virtual void prepare() { }
-			virtual void process() override = 0;
-			virtual bool process(Stereo::buffer buffer) {
-				prepare();
-				while (buffer) {
-					process();
-					buffer++ = out;
-				}
-				return !finished();
+			void process() {
+				out = (a * in) - (b * out);
 			}
-			virtual bool process(mono::buffer* buffers) {
-				buffer buffer = { buffers[0], buffers[1] };
-				return process(buffer);
+
+			void process(const signal* inputs, signal* outputs, int samples) {
+				float x = in, y = out;
+				for (int s = 0; s < samples; s++) {
+					x = inputs[s];
+					outputs[s] = y = (a * x) - (b * y);
+				}
+				in = x;
+				out = y;
 			}
 		};
 
-		// base class for stereo synthesiser mini-plugins
-		struct Synth : public Effect {
-			typedef Stereo::Note Note;
+		// fixed-size delay line (wraps klang::Delay; qualified calls bypass its virtual dispatch)
+		template<int SIZE>
+		struct Delay : public Modifier<Delay<SIZE>> {
+			using Modifier<Delay<SIZE>>::in;
+			using Modifier<Delay<SIZE>>::out;
+			typedef klang::Delay<SIZE> Line;
+		protected:
+			Line line;
+		public:
+			// zeroes the line (cost proportional to the samples written since the last clear)
+			void clear() { line.clear(); }
 
-			struct Notes : klang::Notes<Synth, Note> {
-				using klang::Notes<Synth, Note>::Notes;
-			} notes;
+			void operator<<(const signal& input) { line.Line::operator<<(in = input); }
+			void input(const signal& input) { operator<<(input); }
 
-			Synth() : notes(this) { }
-			virtual ~Synth() { }
+			signal tap(float delay) const { return line.tap(delay); }
 
-			virtual void presetLoaded(int preset) { }
-			virtual void optionChanged(int param, int item) { }
-			virtual void buttonPressed(int param) { };
+			signal& operator>>(signal& destination) {
+				return destination = out = line.Line::operator signal();
+			}
 
-			int indexOf(Note* note) const {
-				int index = 0;
-				for (const auto* n : notes.items) {
-					if (note == n) return
-						index;
-					index++;
-				}
-				return -1; // not found
+			operator signal() {
+				return out = line.Line::operator signal();
+			}
+
+			void process() {
+				operator<<(in);
+				out = line.Line::operator signal();
+			}
+
+			void process(const signal* inputs, signal* outputs, int samples) {
+				if (samples)
+					in = inputs[samples - 1]; // (before an in-place write)
+				line.Line::process(inputs, outputs, samples);
+				out = line.out;
 			}
+
+			void set(param delay) { line.Line::set(delay); }
 		};
-	}
 
-	namespace stereo {
-		using namespace Stereo;
-	}
+		// envelope generator (wraps klang::Envelope or a derived type, e.g. klang::ADSR)
+		template<class ENVELOPE = klang::Envelope>
+		struct Envelope : public Generator<Envelope<ENVELOPE>> {
+			using Generator<Envelope<ENVELOPE>>::out;
+			using Generator<Envelope<ENVELOPE>>::process;
 
-	namespace Oscillators {
-		using namespace klang;
+			ENVELOPE envelope;
 
-		namespace Basic {
-			struct Sine : public Oscillator {
-				void process() {
-					out = sin(position + offset);
-					position += increment;
-				}
-			};
+			template<typename... params>
+			void set(const params&... p) { envelope.set(p...); }
 
-			struct Saw : public Oscillator {
-				void process() {
-					out = position * (1.f / pi) - 1;
-					position += increment;
-				}
-			};
-		};
+			template<typename... params>
+			void release(const params&... p) { envelope.release(p...); }
 
-		namespace Fast {
-			constexpr float pi = 3.1415926535897932384626433832795f;
-			constexpr float twoPi = float(2.0 * 3.1415926535897932384626433832795);
-			constexpr float twoPiInv = float(1.0 / twoPi);
+			bool finished() const { return envelope.finished(); }
 
-			struct Increment {
-				// represent phase delta using full range of int32
-				// (integer math, no conditionals, free oversampling)
-				signed int amount = 0;
+			// Returns the output of the envelope and advances the envelope.
+			signal& operator++(int) { return out = envelope++; }
 
-				void reset() { amount = 0; }
+			void process() {
+				out = envelope.out;
+			}
 
-				// set increment given frequency (in Hz)
-				void set(Frequency f) {
-					constexpr float FC4 = float(261.62556530059862);			// Reference Freq (C4 = 261Hz)
-					constexpr float FC4_FINTMAX = float(261.62556530059862 * 2147483648.0);
-					const float FBASE = (FC4_FINTMAX) / klang::fs;
-					amount = 2u * (signed int)(FBASE / FC4 * f);
-				}
+			// Renders the envelope into a block (advancing the envelope, as per ++)
+			void process(signal* outputs, int samples) {
+				for (int s = 0; s < samples; s++)
+					outputs[s] = out = envelope++;
+			}
+		};
 
-				// convert int32 to float [0, 2pi)
-				operator float() const {
-					const unsigned int i = (amount >> 9) | 0x3f800000;
-					return *(const float*)&i - 1.f;
-				}
+		typedef Envelope<klang::ADSR> ADSR;
+	}
 
-				Increment operator+(const Increment& in) const {
-					return { in.amount + amount };
-				}
-			};
+	// lane-parallel components (e.g. rendering 4 or 8 voices of the same type in one pass)
+	namespace Lanes {
+		template<int N> struct Input : Generic::Input<lanes<N>> { };
+		template<int N> struct Output : Generic::Output<lanes<N>> { };
+		template<int N> struct Generator : Generic::Generator<lanes<N>> { };
+		template<int N> struct Modifier : Generic::Modifier<lanes<N>> { };
+		template<int N> struct Oscillator : Generic::Oscillator<lanes<N>> { };
 
-			struct Phase {
-				// represent phase using full range of uint32
-				// (integer math, no conditionals, free oversampling)
-				unsigned int position = 0;
+		template<int N>
+		inline Modifier<N>& operator>>(lanes<N> input, Modifier<N>& modifier) {
+			modifier << input;
+			return modifier;
+		}
 
-				// convert float [0, 2pi) to uint32
-				Phase& operator=(klang::Phase phase) {
-					constexpr float FINTMAX = 2147483648.0f; // (float)INT_MAX + 1.f;
-					phase = phase * FINTMAX / (2.f * pi);
-					position = (unsigned int)phase;
-					return *this;
+		// fast sine oscillator (one phase and frequency per lane; see Oscillators::Fast::Sine)
+		template<int N>
+		struct Sine : public Oscillator<N> {
+			using Oscillator<N>::out;
 
-					//position = 2u * (signed int)(phase * (float(INT_MAX) + 1.f) * twoPiInv);
-					//return *this;
-				}
+			void reset() override {
+				for (int l = 0; l < N; l++)
+					position[l] = 0;
+			}
 
-				// convert uint32 to float [0, 1)
-				operator float() const {
-					const unsigned int i = (position >> 9) | 0x3f800000;
-					return (*(const float*)&i - 1.f);
+			// set the frequency (all lanes)
+			void set(param frequency) override {
+				Oscillator<N>::frequency = frequency;
+				for (int l = 0; l < N; l++)
+					tune(l, frequency);
+			}
 
-					//// = quarter-turn (pi/2) phase offset
-					//unsigned int phase = position + 0x40000000;
+			// set the frequency and phase (all lanes)
+			void set(param frequency, param phase) override {
+				set(frequency);
+				for (int l = 0; l < N; l++)
+					reset(l, phase);
+			}
 
-					//// range reduce to [0,pi]
-					//if (phase & 0x80000000) // cos(x) = cos(-x)
-					//	phase = ~phase; 
+			// set the frequency (per lane)
+			void tune(const lanes<N>& frequency) {
+				for (int l = 0; l < N; l++)
+					tune(l, frequency[l]);
+			}
 
-					//// convert to float in range [-pi/2,pi/2)
-					//phase = (phase >> 8) | 0x3f800000;
-					//return *(float*)&phase * pi - 3.f/2.f * pi; // 1.0f + (phase / (2^31))
-				}
+			// set the frequency of a single lane (e.g. on note on)
+			void tune(int lane, param frequency) {
+				klang::Oscillators::Fast::Increment i;
+				i.set(frequency);
+				increment[lane] = (unsigned int)i.amount;
+			}
 
-				// returns offset phase
-				float operator+(const Phase& offset) const {
-					
-					unsigned int phase = (position + offset.position) + 0x40000000; // = quarter-turn (pi/2) phase offset
-					// range reduce to [0,pi]
-					if (phase & 0x80000000) // cos(x) = cos(-x)
-						phase = ~phase;
+			// set the phase of a single lane (in radians)
+			void reset(int lane, param phase = 0.f) {
+				klang::Oscillators::Fast::Phase p;
+				p = phase;
+				position[lane] = p.position;
+			}
 
-					// convert to float in range [-pi/2,pi/2)
-					phase = (phase >> 8) | 0x3f800000;
-					return *(float*)&phase * pi - 3.f / 2.f * pi; // 1.0f + (phase / (2^31))
-				}
+			void process() override {
+				klang::Oscillators::Fast::fastsin_bank(position, increment, out.value, N);
+			}
 
-				// convert uint32 to float [0, 2pi)
-				float radians() const {
-					return operator float();
-				}
+			void process(lanes<N>* outputs, int samples) override {
+				for (int s = 0; s < samples; s++)
+					klang::Oscillators::Fast::fastsin_bank(position, increment, outputs[s].value, N);
+				if (samples)
+					out = outputs[samples - 1];
+			}
 
-				// applies increment and returns float [0, 2pi)
-				//float operator+=(Increment i) {
-				//	unsigned int phase = position + 0x40000000; // = quarter-turn (pi/2) phase offset
-				//	position += i.amount;						// apply increment
+		protected:
+			alignas(32) unsigned int position[N] = { 0 };
+			alignas(32) unsigned int increment[N] = { 0 };
+		};
 
-				//	// range reduce to [0,pi]
-				//	if (phase & 0x80000000) // cos(x) = cos(-x)
-				//		phase = ~phase;
+		// one-pole low-pass filter (one coefficient per lane; see Filters::Basic::LPF)
+		template<int N>
+		struct LPF : public Modifier<N> {
+			using Modifier<N>::in;
+			using Modifier<N>::out;
 
-				//	// convert to float in range [-pi/2,pi/2)
-				//	phase = (phase >> 8) | 0x3f800000;
-				//	return *(float*)&phase * pi - 3 / 2.f * pi; // 1.0f + (phase / (2^31))
-				//}
+			lanes<N> a, b;
 
-				// applies increment and returns float [0, 2pi)
-				Phase& operator+=(const Increment i) {
-					position += i.amount;						// apply increment
-					return *this;
-				}
+			void set(param coeff) override {
+				a = coeff.value;
+				b = 1.f - coeff.value;
+			}
 
-				// applies increment and returns float [0, 2pi)
-				//Phase operator+(const Phase& i) const {
-				//	return { position + i.position };				// apply increment
-				//}
+			// set the coefficient of a single lane
+			void setLane(int lane, param coeff) {
+				a[lane] = coeff.value;
+				b[lane] = 1.f - coeff.value;
+			}
 
-				//// applies increment and returns float [0, 2pi)
-				//float operator+=(Increment i) {
-				//	unsigned int phase = position + 0x40000000; // = quarter-turn (pi/2) phase offset
-				//	position += i.amount;						// apply increment
+			void process() override {
+				out = (a * in) + (b * out);
+			}
 
-				//	// range reduce to [0,pi]
-				//	if (phase & 0x80000000) // cos(x) = cos(-x)
-				//		phase = ~phase; 
+			void process(const lanes<N>* inputs, lanes<N>* outputs, int samples) override {
+				lanes<N> y = out;
+				for (int s = 0; s < samples; s++) {
+					in = inputs[s];
+					outputs[s] = y = (a * in) + (b * y);
+				}
+				out = y;
+			}
+		};
 
-				//	// convert to float in range [-pi/2,pi/2)
-				//	phase = (phase >> 8) | 0x3f800000;
-				//	return *(float*)&phase * pi - 3/2.f * pi; // 1.0f + (phase / (2^31))
-				//}
+		// biquad filter (independent coefficients and state per lane, e.g. one per voice or band; see Filters::Biquad)
+		// - coefficients are designed on each set() (no update Policy)
+		template<int N>
+		struct Biquad : public Modifier<N> {
+			using Modifier<N>::in;
+			using Modifier<N>::out;
+			typedef Filters::Biquad::Mode Mode;
+
+			Biquad(Mode mode = Filters::Biquad::LowPass) : mode(mode) { }
+
+			// set the frequency, Q and gain (all lanes)
+			void set(param frequency) override {					set(frequency, 0.70710678f, 0.f);	}
+			void set(param frequency, param Q) override {			set(frequency, Q, 0.f);				}
+			void set(param frequency, param Q, param gain) override {
+				for (int l = 0; l < N; l++)
+					setLane(l, frequency, Q, gain);
+			}
 
-				//Phase& operator+(Phase offset) const {
-				//	offset.position += position;
-				//	return offset;
-				//}
+			// set the frequency, Q and gain of a single lane
+			void setLane(int lane, param frequency, param Q = 0.70710678f, param gain = 0.f) {
+				const auto c = Filters::Biquad::Coefficients::design(mode, frequency, Q, gain);
+				b0[lane] = c.b0; b1[lane] = c.b1; b2[lane] = c.b2;
+				a1[lane] = c.a1; a2[lane] = c.a2;
+			}
 
-				//static void test() {
-				//	Phase p;
-				//	assert((float)(p = 0.f).radians() == 0.f);
-				//	assert((float)(p = pi/2).radians() == pi/2);
-				//	assert((float)(p = pi).radians() == pi);
-				//	assert((float)(p = 3*pi/2).radians() == 3*pi/2);
-				//	assert((float)(p = 2*pi).radians() == 0.f);
-				//}
-			};
+			void reset() {
+				z1 = z2 = 0.f;
+			}
 
-			// sin approximation [-pi/2, pi/2] using odd minimax polynomial (Robin Green)
-			inline static float polysin(float x) {
-				const float x2 = x * x;
-				return (((-0.00018542f * x2 + 0.0083143f) * x2 - 0.16666f) * x2 + 1.0f) * x;
+			void process() override {
+				out = b0 * in + z1;
+				z1 = b1 * in - a1 * out + z2;
+				z2 = b2 * in - a2 * out;
 			}
 
-			// fast sine (based on V2/Farbrausch; using polysin)
-			inline static float fastsin(float x)
-			{
-				// Range reduction to [0, 2pi]
-				//x = fmodf(x, twoPi);
-				//if (x < 0)			// support -ve phase (e.g. for FM)
-				//	x += twoPi;		//
-				x = fast_mod2pi(x);
+			void process(const lanes<N>* inputs, lanes<N>* outputs, int samples) override {
+				lanes<N> s1 = z1, s2 = z2;
+				for (int s = 0; s < samples; s++) {
+					const lanes<N>& x = inputs[s];
+					const lanes<N> y = b0 * x + s1;
+					s1 = b1 * x - a1 * y + s2;
+					s2 = b2 * x - a2 * y;
+					outputs[s] = y;
+				}
+				z1 = s1; z2 = s2;
+				if (samples) {
+					in = inputs[samples - 1];
+					out = outputs[samples - 1];
+				}
+			}
 
-				// Range reduction to [-pi/2, pi/2]
-				if (x > 3/2.f * pi)	// 3/2pi ... 2pi
-					x -= twoPi;	// (= translated)
-				else if (x > pi/2)	// pi/2 ... 3pi/2
-					x = pi - x;		// (= mirrored)
-  
-				return polysin(x);
+		protected:
+			Mode mode;
+			lanes<N> b0 = 1.f, b1, b2, a1, a2;
+			lanes<N> z1, z2;
+		};
+
+		// state-variable filter (independent coefficients and state per lane; see Filters::SVF)
+		// - coefficients are designed on each set() (no update Policy)
+		template<int N>
+		struct SVF : public Modifier<N> {
+			using Modifier<N>::in;
+			using Modifier<N>::out;
+			typedef Filters::SVF::Mode Mode;
+
+			SVF(Mode mode = Filters::SVF::LowPass) : mode(mode) { }
+
+			// set the frequency and Q (all lanes)
+			void set(param frequency) override {				set(frequency, 0.70710678f);	}
+			void set(param frequency, param Q) override {
+				for (int l = 0; l < N; l++)
+					setLane(l, frequency, Q);
 			}
 
-			// fast sine (using polysin and integer math)
-			inline static float fastsinp(unsigned int p)
-			{
-				// Range reduction to [0, 2pi]
-				//x = fmodf(x, twoPi);
-				//if (x < 0)			// support -ve phase (e.g. for FM)
-				//	x += twoPi;		//
-				float x = fast_modp(p);
+			// set the frequency and Q of a single lane
+			void setLane(int lane, param frequency, param Q = 0.70710678f) {
+				const auto c = Filters::SVF::Coefficients::design(mode, frequency, Q);
+				a1[lane] = c.a1; a2[lane] = c.a2; a3[lane] = c.a3;
+				m0[lane] = c.m0; m1[lane] = c.m1; m2[lane] = c.m2;
+			}
 
-				// Range reduction to [-pi/2, pi/2]
-				if (x > 3.f/2.f * pi)	// 3/2pi ... 2pi
-					x -= twoPi;			// (= translated)
-				else if (x > pi/2.f)	// pi/2 ... 3pi/2
-					x = pi - x;			// (= mirrored)
+			void reset() {
+				ic1 = ic2 = 0.f;
+			}
 
-				return polysin(x);
+			void process() override {
+				const lanes<N> v3 = in - ic2;
+				const lanes<N> v1 = a1 * ic1 + a2 * v3;
+				const lanes<N> v2 = ic2 + a2 * ic1 + a3 * v3;
+				ic1 = v1 + v1 - ic1;
+				ic2 = v2 + v2 - ic2;
+				out = m0 * in + m1 * v1 + m2 * v2;
 			}
 
-			struct Sine : public Oscillator {
-				void reset() override {
-					Sine::position = Oscillator::position = 0;
-					Sine::offset = Oscillator::offset = 0;
-					set(Oscillator::frequency, 0.f);
+			void process(const lanes<N>* inputs, lanes<N>* outputs, int samples) override {
+				lanes<N> s1 = ic1, s2 = ic2;
+				for (int s = 0; s < samples; s++) {
+					const lanes<N>& v0 = inputs[s];
+					const lanes<N> v3 = v0 - s2;
+					const lanes<N> v1 = a1 * s1 + a2 * v3;
+					const lanes<N> v2 = s2 + a2 * s1 + a3 * v3;
+					s1 = v1 + v1 - s1;
+					s2 = v2 + v2 - s2;
+					outputs[s] = m0 * v0 + m1 * v1 + m2 * v2;
 				}
-
-				// set the frequency
-				void set(param frequency) override {
-					if (frequency != Oscillator::frequency) {
-						Oscillator::frequency = frequency;
-						increment.set(frequency);
-					}
+				ic1 = s1; ic2 = s2;
+				if (samples) {
+					in = inputs[samples - 1];
+					out = outputs[samples - 1];
 				}
+			}
 
-				void set(param frequency, param phase) override { // set frequency and phase
-					Sine::position = Oscillator::position = phase;
-					Sine::offset = Oscillator::offset = 0;
-					set(frequency);
-				}
+		protected:
+			Mode mode;
+			lanes<N> a1 = 1.f, a2, a3, m0, m1, m2 = 1.f;
+			lanes<N> ic1, ic2;
+		};
 
-				void set(param frequency, relative phase) override { // set frequency and phase
-					set(frequency);
-					set(phase);
-				}
+		// linear ADSR envelope (one stage and level per lane; see klang::ADSR)
+		template<int N>
+		struct ADSR : public Generator<N> {
+			using Generator<N>::out;
 
-				void set(relative phase) override { // set frequency and phase
-					Sine::offset = Oscillator::offset = phase * twoPi;
-				}
+			enum Stage { Attack, Decay, Sustain, Release, Off };
 
-				void process() override {
-					out = fastsinp(position.position + offset.position);
-					position += increment;
-				}
+			param A, D, S, R;
 
-			protected:
-				Fast::Increment increment;
-				Fast::Phase position, offset;
-			};
+			ADSR() {
+				set(0.5, 0.5, 1, 0.5);
+				for (int l = 0; l < N; l++)
+					stage[l] = Off;
+			}
 
-			struct OSM {
-				enum State { // carry:old_up:new_up
-					NewUp = 0b001, NewDown = 0b000,
-					OldUp = 0b010, OldDown = 0b000,
-					Carry = 0b100, NoCarry = 0b000,
+			void set(param attack, param decay, param sustain, param release) override {
+				A = attack + 0.005f;
+				D = decay + 0.005f;
+				S = sustain;
+				R = release + 0.005f;
+			}
 
-					Down		= OldDown|NewDown|NoCarry,  
-					UpDown		= OldUp|NewDown|NoCarry,    
-					Up			= OldUp|NewUp|NoCarry,		
-					DownUpDown	= OldDown|NewDown|Carry,	
-					DownUp		= OldDown|NewUp|Carry,		
-					UpDownUp	= OldUp|NewUp|Carry			
-				};
+			// (re)start the envelope of a single lane (e.g. on note on)
+			void trigger(int lane) {
+				stage[lane] = Attack;
+				level[lane] = 0;
+				rate[lane] = 1.f / (A * fs);
+			}
 
-				Fast::Increment increment;
-				Fast::Phase offset;
-				Fast::Phase duty;
-				State state;
-				float delta;
+			// release the envelope of a single lane (e.g. on note off)
+			void release(int lane) {
+				if (stage[lane] == Off)
+					return;
+				stage[lane] = Release;
+				rate[lane] = level[lane] / (R * fs);
+			}
 
-				void init() {
-					state = (offset.position - increment.amount) < duty.position ? Up : Down;
-				}
-				
-				void set(param frequency) {
-					//if (frequency != Oscillator::frequency) {
-					//	Oscillator::frequency = frequency;
-						increment.set(frequency);
-						delta = increment;
-						init();
-					//}
-				}
+			bool finished(int lane) const { return stage[lane] == Off; }
 
-				void set(param frequency, param phase) {
-					increment.set(frequency);
-					delta = increment;
-					offset = phase;
-					init();
-				}
+			bool finished() const {
+				for (int l = 0; l < N; l++)
+					if (stage[l] != Off)
+						return false;
+				return true;
+			}
 
-				void set(param frequency, param phase, param duty) {
-					increment.set(frequency);
-					delta = increment;
-					offset = phase;
-					OSM::duty = duty * (2 * pi);
-					init();
+			Stage getStage(int lane) const { return stage[lane]; }
+
+			// Returns the output of the envelope and advances the envelope.
+			lanes<N>& operator++(int) {
+				for (int l = 0; l < N; l++) {
+					out[l] = level[l];
+					switch (stage[l]) {
+					case Attack:
+						if ((level[l] += rate[l]) >= 1.f) {
+							level[l] = 1.f;
+							stage[l] = Decay;
+							rate[l] = (1.f - S) / (D * fs);
+						} break;
+					case Decay:
+						if ((level[l] -= rate[l]) <= S) {
+							level[l] = S;
+							stage[l] = Sustain;
+						} break;
+					case Release:
+						if ((level[l] -= rate[l]) <= 0.f) {
+							level[l] = 0.f;
+							stage[l] = Off;
+						} break;
+					case Sustain:
+					case Off:
+						break;
+					}
 				}
+				return out;
+			}
 
-				State tick() {
-					// old_up = new_up, new_up = (cnt < brpt)
-					state = (State)(((state << 1) | (offset.position < duty.position)) & (NewUp|OldUp));
+			void process() override { /* do nothing -> only process on ++ */ }
 
-					// we added freq to cnt going from the previous sample to the current one.
-					// so if cnt is less than freq, we carried.
-					const State transition = (State)(state | (offset.position < (unsigned int)increment.amount ? DownUpDown : Down)); 
+			// Renders the envelope into a block (advancing the envelope, as per ++)
+			void process(lanes<N>* outputs, int samples) override {
+				for (int s = 0; s < samples; s++)
+					outputs[s] = operator++(0);
+			}
 
-					// finally, tick the oscillator
-					offset += increment;
+		protected:
+			Stage stage[N];
+			float level[N] = { };
+			float rate[N] = { };
+		};
+	}
 
-					return transition;
-				}
+	// signal-flow expressions (compile-time graphs, evaluated per sample or rendered in blocks)
+	//  e.g. auto voice = flow(osc) * adsr >> lpf;
+	//       voice >> out;		// single sample
+	//       voice >> buffer;	// whole buffer
+	namespace Flow {
+		constexpr int BLOCK = 64; // samples per block (used for temporary storage)
+
+		template<class NODE>
+		struct Expression {
+			const NODE& node() const { return static_cast<const NODE&>(*this); }
+
+			// renders the expression into an output buffer (in blocks)
+			void process(signal* outputs, int samples) const {
+				for (int offset = 0; offset < samples; offset += BLOCK)
+					node().render((float*)(outputs + offset), std::min(BLOCK, samples - offset));
+			}
+		};
 
-				static float sqr(float x) { return x * x; }
+		template<class TYPE> struct is_expression : std::is_base_of<Expression<TYPE>, TYPE> { };
 
-				float output() {
-					const float f = delta;
-					const float omf = 1.f - f;
-					const float rcpf = 1.f / f;
-					const float col = duty;
+		template<class TYPE> struct is_envelope : std::is_base_of<klang::Envelope, TYPE> { };
+		template<class ENVELOPE> struct is_envelope<Static::Envelope<ENVELOPE>> : std::true_type { };
 
-					const float c1 = 1.f / col;
-					const float c2 = -1.f / (1.0f - col);
+		template<class TYPE> struct is_modifier : std::integral_constant<bool, 
+			std::is_base_of<Generic::Input<signal>, TYPE>::value || std::is_base_of<Static::Modifier<TYPE, signal>, TYPE>::value> { };
 
-					float p = offset - col;
-					float y = 0.0f;
+		// detects native block processing (see Generator::process(outputs, samples) / Modifier::process(inputs, outputs, samples))
+		template<class TYPE, class = void> struct has_block_output : std::false_type { };
+		template<class TYPE> struct has_block_output<TYPE, std::void_t<decltype(std::declval<TYPE&>().process((signal*)nullptr, 0))>> : std::true_type { };
+		template<class TYPE, class = void> struct has_block_process : std::false_type { };
+		template<class TYPE> struct has_block_process<TYPE, std::void_t<decltype(std::declval<TYPE&>().process((const signal*)nullptr, (signal*)nullptr, 0))>> : std::true_type { };
 
-					// state machine action
-					switch (tick())
-					{
-					case Up:
-						// average of linear function = just sample in the middle
-						y = c1 * (p + p - f);
-						break;
+		// constant value (numbers and temporary signals)
+		struct Constant : Expression<Constant> {
+			float value;
 
-					case Down:
-						// again, average of a linear function
-						y = c2 * (p + p - f);
-						break;
+			Constant(float value) : value(value) { }
 
-					case UpDown:
-						y = rcpf * (c2 * sqr(p) - c1 * sqr(p - f));
-						break;
+			float operator()() const { return value; }
+			void render(float* outputs, int samples) const {
+				for (int s = 0; s < samples; s++)
+					outputs[s] = value;
+			}
+		};
 
-					case DownUp:
-						y = -rcpf * (1.f + c2 * sqr(p + omf) - c1 * sqr(p));
-						break;
+		// signal or parameter (read when evaluated)
+		struct Reference : Expression<Reference> {
+			const signal& value;
 
-					case UpDownUp:
-						y = -rcpf * (1.f + c1 * omf * (p + p + omf));
-						break;
+			Reference(const signal& value) : value(value) { }
 
-					case DownUpDown:
-						y = -rcpf * (1.f + c2 * omf * (p + p + omf));
-						break;
+			float operator()() const { return value.value; }
+			void render(float* outputs, int samples) const {
+				const float x = value.value;
+				for (int s = 0; s < samples; s++)
+					outputs[s] = x;
+			}
+		};
 
-					default:
-						assert(false);
-					}
+		// generator component (oscillator, envelope, etc.)
+		template<class TYPE>
+		struct Component : Expression<Component<TYPE>> {
+			TYPE& component;
 
-					return y + 1.f;
-				}
-			};
+			Component(TYPE& component) : component(component) { }
 
-			struct Saw : public Oscillator {
-				void set(param frequency) {
-					osm.set(frequency);
-				}
+			float operator()() const {
+				if constexpr (is_envelope<TYPE>::value)
+					return component++;
+				else
+					return signal(component);
+			}
 
-				void set(param frequency, param phase) {
-					osm.set(frequency, phase);
-				}
+			void render(float* outputs, int samples) const {
+				if constexpr (has_block_output<TYPE>::value)
+					component.process((signal*)outputs, samples);
+				else for (int s = 0; s < samples; s++)
+					outputs[s] = operator()();
+			}
+		};
 
-				void set(param frequency, param phase, param duty) {
-					osm.set(frequency, phase, duty);
-				}
+		// modifier component (filter, delay, etc.) applied to an input expression
+		template<class INPUT, class MODIFIER>
+		struct Chain : Expression<Chain<INPUT, MODIFIER>> {
+			INPUT input;
+			MODIFIER& modifier;
 
-				void process() {
-					out = osm.output();
+			Chain(const INPUT& input, MODIFIER& modifier) : input(input), modifier(modifier) { }
+
+			float operator()() const {
+				modifier << signal(input());
+				return signal(modifier);
+			}
+
+			void render(float* outputs, int samples) const {
+				input.render(outputs, samples);
+				if constexpr (has_block_process<MODIFIER>::value)
+					modifier.process((const signal*)outputs, (signal*)outputs, samples);
+				else for (int s = 0; s < samples; s++) {
+					modifier << signal(outputs[s]);
+					outputs[s] = signal(modifier);
 				}
+			}
+		};
 
-			protected:
-				OSM osm;
-			};
+		struct Add {		static float apply(float a, float b) { return a + b; } };
+		struct Subtract {	static float apply(float a, float b) { return a - b; } };
+		struct Multiply {	static float apply(float a, float b) { return a * b; } };
+		struct Divide {		static float apply(float a, float b) { return a / b; } };
+
+		// arithmetic combination of two expressions
+		template<class LEFT, class RIGHT, class OPERATION>
+		struct Binary : Expression<Binary<LEFT, RIGHT, OPERATION>> {
+			LEFT left;
+			RIGHT right;
+
+			Binary(const LEFT& left, const RIGHT& right) : left(left), right(right) { }
+
+			float operator()() const { 
+				const float a = left();
+				return OPERATION::apply(a, right());
+			}
+
+			void render(float* outputs, int samples) const {
+				float operand[BLOCK];
+				left.render(outputs, samples);
+				right.render(operand, samples);
+				for (int s = 0; s < samples; s++)
+					outputs[s] = OPERATION::apply(outputs[s], operand[s]);
+			}
 		};
 
-		namespace Wavetables {
-			struct Sine : public Wavetable {
-				Sine() : Wavetable(Basic::Sine()) { }
-			};
+		// operand conversion (expression, number, signal or component)
+		template<class NODE> 
+		inline NODE operand(const Expression<NODE>& expression) { return expression.node(); }
 
-			struct Saw : public Wavetable {
-				Saw() : Wavetable(Basic::Saw()) { }
-			};
+		template<class TYPE, typename std::enable_if<std::is_arithmetic<TYPE>::value, int>::type = 0>
+		inline Constant operand(TYPE value) { return (float)value; }
+
+		inline Constant operand(signal&& value) { return value.value; }
+		inline Reference operand(const signal& value) { return value; }
+
+		template<class TYPE, typename std::enable_if<!is_expression<TYPE>::value && !std::is_base_of<signal, TYPE>::value && !std::is_arithmetic<TYPE>::value, int>::type = 0>
+		inline Component<TYPE> operand(TYPE& component) { return component; }
+
+		template<class TYPE> using node = decltype(operand(std::declval<TYPE>()));
+
+		#define KLANG_FLOW_OPERATOR(op, OPERATION) \
+		template<class LEFT, class RIGHT> \
+		inline Binary<LEFT, node<RIGHT>, OPERATION> operator op(const Expression<LEFT>& left, RIGHT&& right) { \
+			return { left.node(), operand(std::forward<RIGHT>(right)) }; \
+		} \
+		template<class LEFT, class RIGHT, typename std::enable_if<!is_expression<std::decay_t<LEFT>>::value, int>::type = 0> \
+		inline Binary<node<LEFT>, RIGHT, OPERATION> operator op(LEFT&& left, const Expression<RIGHT>& right) { \
+			return { operand(std::forward<LEFT>(left)), right.node() }; \
 		}
-	};
 
-	namespace Filters {
-		namespace Basic {
-			struct LPF : public Modifier {
-				float a, b;
+		KLANG_FLOW_OPERATOR(+, Add)
+		KLANG_FLOW_OPERATOR(-, Subtract)
+		KLANG_FLOW_OPERATOR(*, Multiply)
+		KLANG_FLOW_OPERATOR(/, Divide)
+		#undef KLANG_FLOW_OPERATOR
 
-				void set(param coeff) {
-					a = coeff;
-					b = 1 - a;
-				}
+		// apply modifier (e.g. flow(osc) >> lpf)
+		template<class INPUT, class MODIFIER, typename std::enable_if<is_modifier<MODIFIER>::value, int>::type = 0>
+		inline Chain<INPUT, MODIFIER> operator>>(const Expression<INPUT>& input, MODIFIER& modifier) {
+			return { input.node(), modifier };
+		}
 
-				void process() {
-					out = (a * in) + (b * out);
-				}
-			};
+		// evaluate a single sample (e.g. voice >> out)
+		template<class NODE>
+		inline signal& operator>>(const Expression<NODE>& expression, signal& destination) {
+			return destination = expression.node()();
+		}
 
-			struct HPF : public LPF {
-				void process() {
-					out = (a * in) - (b * out);
-				}
-			};
+		// render a whole buffer (e.g. voice >> buffer)
+		template<class NODE>
+		inline klang::buffer& operator>>(const Expression<NODE>& expression, klang::buffer& buffer) {
+			expression.process(&buffer[0], buffer.size);
+			return buffer;
 		}
 	}
 
+	// starts a signal-flow expression (from a component, signal or value)
+	template<class TYPE>
+	inline Flow::node<TYPE> flow(TYPE&& source) { return Flow::operand(std::forward<TYPE>(source)); }
+
 	namespace basic {
 		using namespace klang;
 